@@ -24,6 +24,8 @@
 #include <sstream>
 
 #include <limits>
+#include <cstdint>
+#include <type_traits>
 
 #include <vector>
 #include <map>
@@ -31,6 +33,12 @@
 #include <algorithm>
 
 #include "Z.hpp" // for Polynomial<Z2> specialisattion.
+#include "clmul.hpp"
+#include "kernels.hpp"
+#include "bigint.hpp"
+#include "ntt.hpp"
+#include "small_vector.hpp"
+#include "parse.hpp"
 
 namespace Modulus
 {
@@ -155,20 +163,25 @@ public:
             size_t       hash() const noexcept;
 };
 
-// Represents a Polynomial of Z<2> using vector<bool>.
+// Represents a Polynomial of Z<2> using packed 64-bit words.
 // Provides usual arithmetic, equality comparison, plugging in.
-// Maybe like usual Polynomial class with std::set<deg_type> instead of std::vector<bool>.
+// Multiplication is carry-less word multiplication, division is shift-and-xor on whole words.
 template<typename deg_type>
 class Polynomial<Z<2>, deg_type> // non-literal class (non-trivial destructor)
 {
 private:
-    std::vector<bool> coeffs;
+    using word = Utility::word;
+    static constexpr unsigned word_bits = 64;
 
-    // Dangerous constructor. Use only when sure that highest coefficient is set true!
-    Polynomial(std::vector<bool>      && coeffs) : coeffs(coeffs) {  }
-    Polynomial(std::vector<bool> const & coeffs) : coeffs(coeffs) {  }
+    // Bit i of words[k] is the coefficient of x^(64k + i).
+    // The class is designed to keep words.back() != 0; the zero polynomial has no words.
+    std::vector<word> words;
 
-    // Calculates v += (w >> offset)
+    void normalize() { while (not words.empty() and words.back() == 0) words.pop_back(); }
+
+    bool bit(size_t i) const { return i / word_bits < words.size() and (words[i / word_bits] >> (i % word_bits) & 1u); }
+
+    // Calculates *this += (p << offset)
     Polynomial & add_with_offset(Polynomial const & p, size_t offset);
 
 public:
@@ -178,13 +191,19 @@ public:
 
     static  Polynomial      fromCoeffVector(std::vector<Z<2>> const & coeffs);
     
-    friend  deg_type        deg(Polynomial const & p)    { return p.coeffs.empty() ? 0 : p.coeffs.size() - 1; }
+    friend  deg_type        deg(Polynomial const & p)
+    {
+        return p.words.empty() ? 0 : (p.words.size() - 1) * word_bits + Utility::top_bit(p.words.back());
+    }
             Polynomial      with_monic(deg_type dg = 0) const;
 
-            bool            is_zero() const                                                 { return coeffs.empty(); }
-    friend  bool            operator ==     (Polynomial const & p, Polynomial const & q)    { return p.coeffs == q.coeffs; }
-    friend  bool            operator !=     (Polynomial const & p, Polynomial const & q)    { return p.coeffs != q.coeffs; }
-    friend  bool            operator <      (Polynomial const & p, Polynomial const & q)    { return p.coeffs <  q.coeffs; }
+            Z<2>            leading_coeff() const { return Z<2>(not words.empty()); }
+            Z<2>            at(deg_type k)  const { return Z<2>(bit(k)); }
+
+            bool            is_zero() const                                                 { return words.empty(); }
+    friend  bool            operator ==     (Polynomial const & p, Polynomial const & q)    { return p.words == q.words; }
+    friend  bool            operator !=     (Polynomial const & p, Polynomial const & q)    { return p.words != q.words; }
+    friend  bool            operator <      (Polynomial const & p, Polynomial const & q)    { return p.words <  q.words; }
     
     friend  Polynomial      operator << <>  (Polynomial, deg_type d);
     friend  Polynomial      operator >> <>  (Polynomial, deg_type d);
@@ -202,7 +221,7 @@ public:
     friend  Polynomial      operator -      (Z<2>       const & t,   Polynomial         q) { return q -= Polynomial(t); }
     friend  Polynomial      operator -      (Polynomial         p,   Z<2>       const & t) { return p -= Polynomial(t); }
     friend  Polynomial      operator *      (Polynomial const & p, Z<2> const & t) { return t == Z<2>(0) ? Polynomial() : p; }
-    friend  Polynomial      operator *      (Z<2> const & t, Polynomial const & p) { return p.operator*(t); }
+    friend  Polynomial      operator *      (Z<2> const & t, Polynomial const & p) { return p * t; }
     
     friend  Polynomial      operator +      (Polynomial         p, Polynomial const & q) { return p += q; }
     friend  Polynomial      operator -      (Polynomial const & p, Polynomial const & q) { return p + q; }
@@ -220,8 +239,150 @@ public:
             
     friend  std::ostream &  operator << <>  (std::ostream & os, Polynomial const & p);
     friend  std::istream &  operator >> <>  (std::istream & is, Polynomial       & p);
+
+    // Parses q from [first, last) by Utility::parse_polynomial and sets first behind it. Returns false if it is not well formed.
+    static  bool            parse           (char const * & first, char const * last, Polynomial & q);
     
-            size_t hash() const noexcept { return std::hash<std::vector<bool>>() (coeffs); }
+            size_t hash() const noexcept;
+};
+
+// Polynomial<Z<p>> multiplies by schoolbook, by Karatsuba's method from karatsuba coefficients of the shorter factor on,
+// by Kronecker substitution, i. e. as integers (see bigint.hpp), from kronecker coefficients on,
+// and by the number theoretic transform (see ntt.hpp) from ntt coefficients on.
+// The thresholds depend on p; calibrate_multiplication<p>() in calibrate.hpp measures them on the running machine.
+struct MulThresholds
+{
+    size_t karatsuba;
+    size_t kronecker;
+    size_t ntt;
+};
+
+template <unsigned p>
+MulThresholds default_mul_thresholds()
+{
+    // Measured with testing/calibrate.cpp. With 16-bit lanes (see kernels.hpp) the schoolbook stays competitive for long.
+    if (Utility::lazy_rows<p>() > 0) return { 1024, 2048, 8192 };
+    return { 24, 16, 2048 };
+}
+
+template <unsigned p>
+MulThresholds & mul_thresholds()
+{
+    static MulThresholds thresholds = default_mul_thresholds<p>();
+    return thresholds;
+}
+
+// Represents a Polynomial of Z<p> using one contiguous array of coefficients.
+// The coefficients are stored in the smallest unsigned type that holds 0 ... p-1, so for p <= 256 they are bytes.
+// Polynomials of low degree (as generated by the sieve) fit into the object itself and do not allocate.
+// Provides the same interface as the generic Polynomial class.
+template <unsigned p, typename deg_type>
+class Polynomial<Z<p>, deg_type> // non-literal class (non-trivial destructor)
+{
+    static_assert(std::numeric_limits<deg_type>::is_integer and not std::numeric_limits<deg_type>::is_signed,
+            "deg_type must be an unsigned integer.");
+
+private:
+    using K          = Z<p>;
+    using coeff_type = typename std::conditional<p != 0 and p <= 0x100u,   std::uint8_t,
+                       typename std::conditional<p != 0 and p <= 0x10000u, std::uint16_t,
+                                                                           std::uint32_t>::type>::type;
+
+    // coeffs[i] is the coefficient of x^i, reduced modulo p. For the runtime modulus p = 0 they are 32 bit.
+    // The class is designed to keep coeffs.back() != 0; the zero polynomial has no coefficients.
+    Utility::small_vector<coeff_type, 24 / sizeof(coeff_type)> coeffs;
+
+    void normalize() { while (not coeffs.empty() and coeffs.back() == 0) coeffs.pop_back(); }
+
+    static coeff_type raw(K const & t) { return static_cast<coeff_type>(static_cast<unsigned>(t)); }
+
+    static coeff_type add(coeff_type a, coeff_type b) { std::uint64_t s = a + std::uint64_t(b);  return s >= K::modulus() ? s - K::modulus() : s; }
+    static coeff_type mul(coeff_type a, coeff_type b) { return K::reduce_wide(static_cast<std::uint64_t>(a) * b); }
+
+    // Calculates *this += (t * q << offset) in place.
+    Polynomial & add_scaled(Polynomial const & q, coeff_type t, size_t offset);
+
+    static  Polynomial      shift_left      (Polynomial const & f,  deg_type d);
+    static  Polynomial      shift_right     (Polynomial const & f,  deg_type d);
+    static  Polynomial      multiply        (Polynomial const & f,  Polynomial const & q);
+
+    // For p <= 181 products and remainders accumulate in 16 bit and are reduced lazily, see kernels.hpp.
+    using lazy = std::integral_constant<bool, (Utility::lazy_rows<p>() > 0)>;
+
+    static coeff_type sub(coeff_type a, coeff_type b) { return a >= b ? a - b : a + (K::modulus() - b); }
+
+    // The multiplication tiers on coefficient arrays, see MulThresholds. Each sets r[0 .. na + nb - 1).
+    static  void            mul_schoolbook  (coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb, std::false_type);
+    static  void            mul_schoolbook  (coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb, std::true_type);
+    static  void            mul_karatsuba   (coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb);
+    static  void            mul_kronecker   (coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb, unsigned bits);
+    // r[0 .. 2n - 1) = a[0 .. n) * b[0 .. n); scratch must hold 4n + 64 coefficients.
+    static  void            mul_karatsuba_square(coeff_type * r, coeff_type const * a, coeff_type const * b, size_t n, coeff_type * scratch);
+
+    static  std::pair<Polynomial, Polynomial> divmod(Polynomial a, Polynomial const & b, std::false_type);
+    static  std::pair<Polynomial, Polynomial> divmod(Polynomial a, Polynomial const & b, std::true_type);
+
+    static  std::ostream &  write           (std::ostream &, Polynomial const &);
+    static  std::istream &  read            (std::istream &, Polynomial       &);
+
+public:
+    static constexpr Eks<K, deg_type> X = Eks<K, deg_type>();
+
+    Polynomial() { }
+    Polynomial(K const & t, deg_type deg = 0);
+
+    static  Polynomial      fromCoeffVector(std::vector<K> const & coeffs);
+
+    friend  deg_type        deg(Polynomial const & f)   { return f.coeffs.empty() ? 0 : f.coeffs.size() - 1; }
+            Polynomial      with_monic(deg_type dg = 0) const;
+
+            K               leading_coeff() const { return coeffs.empty() ? K() : K(unsigned(coeffs.back())); }
+            K               at(deg_type k)  const { return k < coeffs.size() ? K(unsigned(coeffs[k])) : K(); }
+
+            bool is_zero() const                                          { return coeffs.empty(); }
+    friend  bool operator == (Polynomial const & f, Polynomial const & q) { return f.coeffs == q.coeffs; }
+    friend  bool operator != (Polynomial const & f, Polynomial const & q) { return f.coeffs != q.coeffs; }
+    friend  bool operator <  (Polynomial const & f, Polynomial const & q) { return f.coeffs <  q.coeffs; }
+
+    friend  Polynomial      operator <<     (Polynomial const & f,  deg_type d) { return shift_left(f, d); }
+    friend  Polynomial      operator >>     (Polynomial const & f,  deg_type d) { return shift_right(f, d); }
+            Polynomial &    operator<<=     (                       deg_type d) & { return *this = *this << d; }
+            Polynomial &    operator>>=     (                       deg_type d) & { return *this = *this >> d; }
+
+    static  std::pair<Polynomial, Polynomial> divmod(Polynomial         a, Polynomial const & b) { return divmod(std::move(a), b, lazy()); }
+    static  void                              divmod(Polynomial const & a, Polynomial const & b, Polynomial & q, Polynomial & r);
+
+    friend  Polynomial      operator +      (Polynomial f) { return f; }
+            Polynomial      operator -      () const;
+
+    friend  Polynomial      operator +      (K          const & t,   Polynomial         q) { return q += Polynomial(t); }
+    friend  Polynomial      operator +      (Polynomial         f,   K          const & t) { return f += Polynomial(t); }
+    friend  Polynomial      operator -      (K          const & t,   Polynomial         q) { return -(q -= Polynomial(t)); }
+    friend  Polynomial      operator -      (Polynomial         f,   K          const & t) { return f -= Polynomial(t); }
+    friend  Polynomial      operator *      (K          const & t,   Polynomial         q) { return q *= t; }
+    friend  Polynomial      operator *      (Polynomial         f,   K          const & t) { return f *= t; }
+
+    friend  Polynomial      operator +      (Polynomial         f,   Polynomial const & q) { return f += q; }
+    friend  Polynomial      operator -      (Polynomial         f,   Polynomial const & q) { return f -= q; }
+    friend  Polynomial      operator *      (Polynomial const & f,   Polynomial const & q) { return multiply(f, q); }
+    friend  Polynomial      operator /      (Polynomial const & f,   Polynomial const & q) { return divmod(f, q).first; }
+    friend  Polynomial      operator %      (Polynomial const & f,   Polynomial const & q) { return divmod(f, q).second; }
+
+            Polynomial &    operator *=     (K          const & t) &;
+
+            Polynomial &    operator +=     (Polynomial const & q) & { return add_scaled(q, 1, 0); }
+            Polynomial &    operator -=     (Polynomial const & q) & { return add_scaled(q, K::modulus() - 1, 0); }
+            Polynomial &    operator *=     (Polynomial const & q) & { return *this = *this * q; }
+            Polynomial &    operator /=     (Polynomial const & q) & { return *this = *this / q; }
+            Polynomial &    operator %=     (Polynomial const & q) & { return *this = *this % q; }
+
+    friend  std::ostream &  operator <<     (std::ostream & os, Polynomial const & f) { return write(os, f); }
+    friend  std::istream &  operator >>     (std::istream & is, Polynomial       & f) { return read(is, f); }
+
+    // Parses q from [first, last) by Utility::parse_polynomial and sets first behind it. Returns false if it is not well formed.
+    static  bool            parse           (char const * & first, char const * last, Polynomial & q);
+
+            size_t hash() const noexcept;
 };
 
 } // namespace Modulus
@@ -137,15 +137,20 @@ Polynomial<T, deg_type>::divmod(Polynomial<T, deg_type> a, Polynomial<T, deg_typ
 {
     if (b.coeffs.empty()) return std::make_pair(Polynomial(), Polynomial());
     
-    using namespace std;
     Polynomial<T, deg_type> q;
-    while (deg(a) >= deg(b))
+    
+    // The leading coefficient of b is inverted only once; then c * b << d is subtracted from a in place.
+    T const inv_lead = T(1) / b.leading_coeff();
+    while (not a.coeffs.empty() and deg(a) >= deg(b))
     {
         auto const d = deg(a) - deg(b);
-        auto const c = a.leading_coeff() / b.leading_coeff();
+        T    const c = a.leading_coeff() * inv_lead;
         q.coeffs[d] = c;
-        auto const subtr = b * c << d;
-        a -= subtr;
+        for (auto const & dcp : b.coeffs)
+        {
+            auto const it = a.coeffs.emplace(dcp.first + d, T()).first;
+            if ((it->second -= c * dcp.second) == T()) a.coeffs.erase(it);
+        }
     }
     return std::make_pair(std::move(q), std::move(a));
 }
@@ -296,7 +301,7 @@ bool read_monom(std::istringstream & is, deg_type & deg, T & coeff)
         }
     }
 
-    return is;
+    return static_cast<bool>(is);
 }
 
 void str_replace(std::string & subject, std::string const & search, std::string const & replace)
@@ -366,9 +371,10 @@ namespace Modulus
 
 template <typename deg_type>
 ZPoly<2, deg_type>::Polynomial(Z<2> const & z, deg_type deg)
-    : coeffs(z == Z<2>() ? 0 : deg + 1)
 {
-    if (not coeffs.empty()) coeffs[deg] = true;
+    if (z == Z<2>()) return;
+    words.resize(deg / word_bits + 1);
+    words.back() = word(1) << (deg % word_bits);
 }
 
 template <typename deg_type>
@@ -376,9 +382,10 @@ ZPoly<2, deg_type>
 ZPoly<2, deg_type>::fromCoeffVector(std::vector<Z<2>> const & coeffs)
 {
     ZPoly<2, deg_type>  res;
-    res.coeffs.reserve(coeffs.size());
-    for (Z<2> z : coeffs) res.coeffs.push_back(z != Z<2>());
-    while (not res.coeffs.empty() and not res.coeffs.back()) res.coeffs.pop_back();
+    res.words.resize((coeffs.size() + word_bits - 1) / word_bits);
+    for (size_t i = 0; i < coeffs.size(); ++i)
+        if (coeffs[i] != Z<2>()) res.words[i / word_bits] |= word(1) << (i % word_bits);
+    res.normalize();
     return res;
 }
 
@@ -389,8 +396,9 @@ ZPoly<2, deg_type>
 ZPoly<2, deg_type>::with_monic(deg_type dg) const
 {
     ZPoly<2, deg_type> result = *this;
-    if (dg < result.coeffs.size()) { result.coeffs.push_back(true); }
-    else                           { result.coeffs.resize(dg+1); result.coeffs[dg] = true; }
+    size_t const d = is_zero() ? dg : std::max<size_t>(deg(result) + 1, dg);
+    if (result.words.size() <= d / word_bits) result.words.resize(d / word_bits + 1);
+    result.words[d / word_bits] |= word(1) << (d % word_bits);
     return result;
 }
 
@@ -400,9 +408,21 @@ template <typename deg_type>
 ZPoly<2, deg_type>
     operator <<(ZPoly<2, deg_type> p, deg_type d)
 {
-    p.coeffs.resize(p.coeffs.size() + d);
-    for (deg_type k = p.coeffs.size() - 1; k >= d; ++k) p.coeffs[k] = p.coeffs[k-d];
-    for (deg_type k = 0; k < d; ++k) p.coeffs[k] = false;
+    using word = Utility::word;
+    if (p.is_zero() or d == 0) return p;
+    
+    size_t const wshift = d / 64,
+                 bshift = d % 64;
+    auto & v = p.words;
+    v.resize(v.size() + wshift + 1);
+    for (size_t k = v.size() - 1; k > wshift; --k)
+    {
+        word const lower = bshift ? v[k - wshift - 1] >> (64 - bshift) : 0;
+        v[k] = v[k - wshift] << bshift | lower;
+    }
+    v[wshift] = v[0] << bshift;
+    std::fill(v.begin(), v.begin() + wshift, word(0));
+    p.normalize();
     return p;
 }
 
@@ -410,24 +430,54 @@ template <typename deg_type>
 ZPoly<2, deg_type>
     operator >>(ZPoly<2, deg_type> p, deg_type d)
 {
-    deg_type k;
-    for (k = 0; d < p.coeffs.size(); ++k, ++d) p.coeffs[k] = std::move(p.coeffs[d]);
-    p.coeffs.resize(k);
+    using word = Utility::word;
+    size_t const wshift = d / 64,
+                 bshift = d % 64;
+    auto & v = p.words;
+    if (wshift >= v.size()) return ZPoly<2, deg_type>();
+    
+    for (size_t k = 0; k + wshift < v.size(); ++k)
+    {
+        word const upper = (bshift and k + wshift + 1 < v.size()) ? v[k + wshift + 1] << (64 - bshift) : 0;
+        v[k] = v[k + wshift] >> bshift | upper;
+    }
+    v.resize(v.size() - wshift);
+    p.normalize();
     return p;
 }
 
 // Arithmetric //
 
+// Calculates v ^= (w << offset) on whole words. v must be large enough to hold the result.
+inline void xor_shifted(Utility::word * v, Utility::word const * w, size_t wsize, size_t offset)
+{
+    size_t const wshift = offset / 64,
+                 bshift = offset % 64;
+    v += wshift;
+    if (bshift == 0)
+    {
+        for (size_t i = 0; i < wsize; ++i) v[i] ^= w[i];
+        return;
+    }
+    Utility::word carry = 0;
+    for (size_t i = 0; i < wsize; ++i)
+    {
+        v[i] ^= w[i] << bshift | carry;
+        carry = w[i] >> (64 - bshift);
+    }
+    if (carry) v[wsize] ^= carry;
+}
+
 template <typename deg_type>
 ZPoly<2, deg_type> &
 ZPoly<2, deg_type>::add_with_offset(ZPoly<2, deg_type> const & p, size_t offset)
 {
-    std::vector<bool>       & v =   coeffs;
-    std::vector<bool> const & w = p.coeffs;
+    if (p.is_zero()) return *this;
     
-    if (v.size() < w.size() + offset) v.resize(w.size() + offset);
-    for (size_t i = 0; i < w.size(); ++i, ++offset) v[offset] = v[offset] != w[i];
-    while (not v.empty() and not v.back()) v.pop_back();
+    size_t const needed = (deg(p) + offset) / word_bits + 1;
+    if (words.size() < needed) words.resize(needed);
+    xor_shifted(words.data(), p.words.data(), p.words.size(), offset);
+    normalize();
     
     return *this;
 }
@@ -437,8 +487,11 @@ ZPoly<2, deg_type>
     operator * (ZPoly<2, deg_type> const & p, ZPoly<2, deg_type> const & q)
 {
     ZPoly<2, deg_type>  res;
-    res.coeffs.reserve(p.coeffs.size() + q.coeffs.size());
-    for (size_t i = 0; i < p.coeffs.size(); ++i) if (p.coeffs[i]) res.add_with_offset(q, i);
+    if (p.is_zero() or q.is_zero()) return res;
+    
+    res.words.resize(p.words.size() + q.words.size());
+    Utility::clmul_multiply(res.words.data(), p.words.data(), p.words.size(), q.words.data(), q.words.size());
+    res.normalize();
     return res;
 }
 
@@ -449,27 +502,23 @@ ZPoly<2, deg_type>::divmod(ZPoly<2, deg_type> a, ZPoly<2, deg_type> const & b)
     if (b.is_zero()) return std::make_pair(ZPoly<2, deg_type>(), ZPoly<2, deg_type>());
 
     ZPoly<2, deg_type> q;
-    while (a.coeffs.size() >= b.coeffs.size())
+    size_t const db = deg(b);
+    if (not a.is_zero() and deg(a) >= db)
     {
-        auto v_xor_eq = [](std::vector<bool> & v, std::vector<bool> const & w)
-            {
-                auto itv = v.rbegin(); // iterator
-                auto itw = w.rbegin(); // const_iterator
-                do
-                {
-                    if (*itw) itv->flip();
-                }
-                while (++itv, ++itw != w.rend());
-            };
+        size_t const da = deg(a);
+        q.words.resize((da - db) / word_bits + 1);
         
-        q.coeffs.push_back(a.coeffs.back());
-        if (a.coeffs.back()) v_xor_eq(a.coeffs, b.coeffs);
-        // a.back() is definitely false.
-        a.coeffs.pop_back();
+        // Eliminate the leading terms of a from the top: whenever bit i is set, a ^= b << (i - db).
+        // Then bits > i of a are zero, so b << (i - db) always fits into the words of a.
+        for (size_t i = da + 1; i-- > db; )
+        {
+            if (not a.bit(i)) continue;
+            xor_shifted(a.words.data(), b.words.data(), b.words.size(), i - db);
+            q.words[(i - db) / word_bits] |= word(1) << ((i - db) % word_bits);
+        }
+        a.normalize();
+        q.normalize();
     }
-    
-    std::reverse(q.coeffs.begin(), q.coeffs.end());
-    while (not a.coeffs.empty() and not a.coeffs.back()) a.coeffs.pop_back();
     return std::make_pair( std::move(q), std::move(a) );
 }
 
@@ -486,18 +535,18 @@ void ZPoly<2, deg_type>::divmod(ZPoly<2, deg_type> const & a, ZPoly<2, deg_type>
 template <typename deg_type>
 std::ostream & operator <<(std::ostream & os, ZPoly<2, deg_type> const & p)
 {
-    auto & v = p.coeffs;
-    switch (v.size())
+    if (p.is_zero()) return os << '0';
+    
+    size_t i = deg(p);
+    switch (i)
     {
-        case 0: os << '0'; break;
-        case 1: os << '1'; break;
-        case 2: os << "x"; if (v[0]) os << " + 1"; break;
+        case 0: os << '1'; break;
+        case 1: os << "x"; if (p.bit(0)) os << " + 1"; break;
         default:
-            size_t i = v.size() - 1;
             os << "x^" << i;
-            while (--i > 1) if (v[i]) os << " + x^" << i;
-            if (v[1]) os << " + x";
-            if (v[0]) os << " + 1";
+            while (--i > 1) if (p.bit(i)) os << " + x^" << i;
+            if (p.bit(1)) os << " + x";
+            if (p.bit(0)) os << " + 1";
     }
     return os;
 }
@@ -505,35 +554,393 @@ std::ostream & operator <<(std::ostream & os, ZPoly<2, deg_type> const & p)
 template <typename deg_type>
 std::istream & operator >>(std::istream & is, ZPoly<2, deg_type>       & p)
 {
-    using std::istringstream;
     using K = Z<2>;
     using KPoly = ZPoly<2, deg_type>;
     
     p = K();
     std::string inp;
     if (!(is >> inp)) return is;
-    for (auto & c : inp) if (c == '+' or c == '-') c = ' ';
 
-    istringstream iss(inp);
+    char const * first = inp.data();
+    if (not KPoly::parse(first, first + inp.size(), p) or first != inp.data() + inp.size()) is.setstate(std::ios_base::failbit);
+    return is;
+}
+
+template <typename deg_type>
+bool ZPoly<2, deg_type>::parse(char const * & first, char const * last, Polynomial & q)
+{
+    q = Polynomial();
+    bool const ok = Utility::parse_polynomial(first, last, 2, [&q](size_t d, std::uint64_t a)
+    {
+        if (a == 0) return;
+        if (q.words.size() <= d / word_bits) q.words.resize(d / word_bits + 1, 0);
+        q.words[d / word_bits] ^= word(1) << (d % word_bits);
+    });
+    q.normalize();
+    return ok;
+}
+
+// Hash //
+
+template <typename deg_type>
+size_t ZPoly<2, deg_type>::hash() const noexcept
+{
+    std::hash<word> whash;
     
-    // reuse inp!
-    while(iss >> inp)
+    size_t res = words.size();
+    for (word w : words) res ^= whash(w) + 0x9e3779b97f4a7c15ull + (res << 6) + (res >> 2);
+    return res;
+}
+
+} // namespace Modulus
+
+
+
+// Polynomial<Z<p>> //
+namespace Modulus
+{
+
+// Constructors //
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type>::Polynomial(Z<p> const & t, deg_type deg)
+{
+    if (t == Z<p>()) return;
+    coeffs.resize(deg + 1);
+    coeffs[deg] = raw(t);
+}
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type>
+Polynomial<Z<p>, deg_type>::fromCoeffVector(std::vector<Z<p>> const & coeffs)
+{
+    Polynomial res;
+    res.coeffs.resize(coeffs.size());
+    for (size_t i = 0; i < coeffs.size(); ++i) res.coeffs[i] = raw(coeffs[i]);
+    res.normalize();
+    return res;
+}
+
+// Methods //
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type>
+Polynomial<Z<p>, deg_type>::with_monic(deg_type dg) const
+{
+    Polynomial result = *this;
+    size_t const d = std::max<size_t>(coeffs.size(), dg);
+    if (result.coeffs.size() <= d) result.coeffs.resize(d + 1);
+    result.coeffs[d] = 1;
+    return result;
+}
+
+// Shift //
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type>
+Polynomial<Z<p>, deg_type>::shift_left(Polynomial const & q, deg_type d)
+{
+    if (q.is_zero()) return q;
+    Polynomial res;
+    res.coeffs.resize(q.coeffs.size() + d);
+    std::copy(q.coeffs.begin(), q.coeffs.end(), res.coeffs.begin() + d);
+    return res;
+}
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type>
+Polynomial<Z<p>, deg_type>::shift_right(Polynomial const & q, deg_type d)
+{
+    Polynomial res;
+    if (d >= q.coeffs.size()) return res;
+    res.coeffs.resize(q.coeffs.size() - d);
+    std::copy(q.coeffs.begin() + d, q.coeffs.end(), res.coeffs.begin());
+    return res;
+}
+
+// Arithmetric //
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type>
+Polynomial<Z<p>, deg_type>::operator - () const
+{
+    Polynomial res = *this;
+    for (auto & c : res.coeffs) if (c != 0) c = K::modulus() - c;
+    return res;
+}
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type> &
+Polynomial<Z<p>, deg_type>::operator *=(Z<p> const & t) &
+{
+    coeff_type const r = raw(t);
+    if (r == 0) coeffs.clear();
+    else if (r != 1)
     {
-        istringstream iss_inp(inp);
-        unsigned u;
-        if      (iss_inp >> u) p += K(u);
-        else if (inp == "x")   p += KPoly(K(1), 1);
-        else
+        for (auto & c : coeffs) c = mul(c, r);
+        normalize();
+    }
+    return *this;
+}
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type> &
+Polynomial<Z<p>, deg_type>::add_scaled(Polynomial const & q, coeff_type t, size_t offset)
+{
+    if (q.is_zero() or t == 0) return *this;
+    if (coeffs.size() < q.coeffs.size() + offset) coeffs.resize(q.coeffs.size() + offset);
+    
+    coeff_type       * v = coeffs.data() + offset;
+    coeff_type const * w = q.coeffs.data();
+    if (t == 1) for (size_t j = 0; j < q.coeffs.size(); ++j) v[j] = add(v[j], w[j]);
+    else        for (size_t j = 0; j < q.coeffs.size(); ++j) v[j] = add(v[j], mul(t, w[j]));
+    normalize();
+    return *this;
+}
+
+template <unsigned p, typename deg_type>
+Polynomial<Z<p>, deg_type>
+Polynomial<Z<p>, deg_type>::multiply(Polynomial const & a, Polynomial const & b)
+{
+    Polynomial res;
+    if (a.is_zero() or b.is_zero()) return res;
+
+    size_t const na = a.coeffs.size(),
+                 nb = b.coeffs.size(),
+                 n  = std::min(na, nb);
+    MulThresholds const & thresholds = mul_thresholds<p>();
+    unsigned const        bits       = n >= thresholds.kronecker ? Utility::kronecker_bits(K::modulus(), n) : 65;
+
+    res.coeffs.resize(na + nb - 1);
+    coeff_type * r = res.coeffs.data();
+    if      (n >= thresholds.ntt and na + nb - 1 <= Utility::ntt_max_length())
+        Utility::ntt_multiply(r, a.coeffs.data(), na, b.coeffs.data(), nb, K::modulus());
+    else if (bits <= 64)                  mul_kronecker (r, a.coeffs.data(), na, b.coeffs.data(), nb, bits);
+    else if (n >= thresholds.karatsuba)   mul_karatsuba (r, a.coeffs.data(), na, b.coeffs.data(), nb);
+    else                                  mul_schoolbook(r, a.coeffs.data(), na, b.coeffs.data(), nb, lazy());
+    res.normalize();
+    return res;
+}
+
+template <unsigned p, typename deg_type>
+void Polynomial<Z<p>, deg_type>::mul_schoolbook(coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb, std::false_type)
+{
+    std::fill(r, r + na + nb - 1, coeff_type(0));
+    for (size_t i = 0; i < na; ++i)
+    {
+        coeff_type const ai = a[i];
+        if (ai == 0) continue;
+        for (size_t j = 0; j < nb; ++j) r[i + j] = add(r[i + j], mul(ai, b[j]));
+    }
+}
+
+template <unsigned p, typename deg_type>
+std::pair<Polynomial<Z<p>, deg_type>, Polynomial<Z<p>, deg_type>>
+Polynomial<Z<p>, deg_type>::divmod(Polynomial a, Polynomial const & b, std::false_type)
+{
+    if (b.is_zero()) return std::make_pair(Polynomial(), Polynomial());
+    
+    Polynomial q;
+    size_t const db = b.coeffs.size() - 1;
+    if (a.coeffs.size() <= db) return std::make_pair(std::move(q), std::move(a));
+    
+    // The leading coefficient of b is inverted only once; then a is reduced in place from the top.
+    coeff_type const inv_lead = raw(Z<p>(1) / b.leading_coeff());
+    q.coeffs.resize(a.coeffs.size() - db);
+    for (size_t i = a.coeffs.size(); i-- > db; )
+    {
+        if (a.coeffs[i] == 0) continue;
+        coeff_type const c   = mul(a.coeffs[i], inv_lead),
+                         neg = K::modulus() - c;
+        q.coeffs[i - db] = c;
+        coeff_type * v = a.coeffs.data() + (i - db);
+        for (size_t j = 0; j < db; ++j) v[j] = add(v[j], mul(neg, b.coeffs[j]));
+        a.coeffs[i] = 0;
+    }
+    a.coeffs.resize(db);
+    a.normalize();
+    q.normalize();
+    return std::make_pair(std::move(q), std::move(a));
+}
+
+template <unsigned p, typename deg_type>
+void Polynomial<Z<p>, deg_type>::mul_schoolbook(coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb, std::true_type)
+{
+    constexpr size_t rows = Utility::lazy_rows<p>();
+    size_t const n = na + nb - 1;
+    Utility::small_vector<std::uint16_t, 64> acc(n);
+
+    // Each block of rows is accumulated without reduction; only the accumulators later rows add to are reduced in between.
+    for (size_t i = 0; i < na; i += rows)
+    {
+        size_t const m = std::min(rows, na - i);
+        Utility::mul_add(acc.data() + i, a + i, m, b, nb);
+        if (i + m < na) for (size_t k = i + m; k < std::min(n, i + m + nb); ++k) acc[k] %= p;
+    }
+    for (size_t k = 0; k < n; ++k) r[k] = static_cast<coeff_type>(acc[k] % p);
+}
+
+template <unsigned p, typename deg_type>
+void Polynomial<Z<p>, deg_type>::mul_karatsuba_square(coeff_type * r, coeff_type const * a, coeff_type const * b, size_t n, coeff_type * scratch)
+{
+    if (n < std::max<size_t>(2, mul_thresholds<p>().karatsuba)) { mul_schoolbook(r, a, n, b, n, lazy());  return; }
+
+    // (a1 t + a0)(b1 t + b0) = a1 b1 t^2 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) t + a0 b0 with t = x^m.
+    size_t const m = n / 2,
+                 h = n - m;
+    mul_karatsuba_square(r,         a,     b,     m, scratch);
+    r[2 * m - 1] = 0;
+    mul_karatsuba_square(r + 2 * m, a + m, b + m, h, scratch);
+
+    coeff_type * sa   = scratch,
+               * sb   = sa + h,
+               * pr   = sb + h,
+               * next = pr + 2 * h;
+    for (size_t i = 0; i < h; ++i)
+    {
+        sa[i] = i < m ? add(a[m + i], a[i]) : a[m + i];
+        sb[i] = i < m ? add(b[m + i], b[i]) : b[m + i];
+    }
+    mul_karatsuba_square(pr, sa, sb, h, next);
+
+    for (size_t k = 0; k + 1 < 2 * m; ++k) pr[k] = sub(pr[k], r[k]);
+    for (size_t k = 0; k + 1 < 2 * h; ++k) pr[k] = sub(pr[k], r[2 * m + k]);
+    for (size_t k = 0; k + 1 < 2 * h; ++k) r[m + k] = add(r[m + k], pr[k]);
+}
+
+template <unsigned p, typename deg_type>
+void Polynomial<Z<p>, deg_type>::mul_karatsuba(coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb)
+{
+    if (na < nb) { std::swap(a, b);  std::swap(na, nb); }
+
+    // The longer factor is multiplied in blocks of the length of the shorter one.
+    std::vector<coeff_type> block(nb), prod(2 * nb - 1), scratch(4 * nb + 64);
+    std::fill(r, r + na + nb - 1, coeff_type(0));
+    for (size_t i = 0; i < na; i += nb)
+    {
+        size_t const len = std::min(nb, na - i);
+        std::copy(a + i, a + i + len, block.begin());
+        std::fill(block.begin() + len, block.end(), coeff_type(0));
+        mul_karatsuba_square(prod.data(), block.data(), b, nb, scratch.data());
+
+        size_t const n = std::min(2 * nb - 1, na + nb - 1 - i);
+        for (size_t k = 0; k < n; ++k) r[i + k] = add(r[i + k], prod[k]);
+    }
+}
+
+template <unsigned p, typename deg_type>
+void Polynomial<Z<p>, deg_type>::mul_kronecker(coeff_type * r, coeff_type const * a, size_t na, coeff_type const * b, size_t nb, unsigned bits)
+{
+    using Utility::bigword;
+    size_t const wa = (na * bits + 63) / 64,
+                 wb = (nb * bits + 63) / 64;
+    std::vector<bigword> ia(wa), ib(wb), ir(wa + wb);
+    Utility::kronecker_pack(ia.data(), a, na, bits);
+    Utility::kronecker_pack(ib.data(), b, nb, bits);
+    Utility::bigmul(ir.data(), ia.data(), wa, ib.data(), wb);
+
+    for (size_t k = 0; k < na + nb - 1; ++k)
+        r[k] = static_cast<coeff_type>(Utility::kronecker_slot(ir.data(), k, bits) % K::modulus());
+}
+
+template <unsigned p, typename deg_type>
+std::pair<Polynomial<Z<p>, deg_type>, Polynomial<Z<p>, deg_type>>
+Polynomial<Z<p>, deg_type>::divmod(Polynomial a, Polynomial const & b, std::true_type)
+{
+    if (b.is_zero()) return std::make_pair(Polynomial(), Polynomial());
+
+    Polynomial q;
+    size_t const db = b.coeffs.size() - 1;
+    if (a.coeffs.size() <= db) return std::make_pair(std::move(q), std::move(a));
+
+    constexpr size_t rows = Utility::lazy_rows<p>();
+    Utility::small_vector<std::uint16_t, 64> acc(a.coeffs.size());
+    std::copy(a.coeffs.begin(), a.coeffs.end(), acc.begin());
+
+    // As in the reduced version, but a coefficient is only reduced when it becomes the leading one.
+    // After rows subtractions the accumulators below the current one are reduced, as only those are touched since.
+    coeff_type const inv_lead = raw(Z<p>(1) / b.leading_coeff());
+    q.coeffs.resize(a.coeffs.size() - db);
+    size_t pending = 0;
+    for (size_t i = a.coeffs.size(); i-- > db; )
+    {
+        coeff_type const lead = static_cast<coeff_type>(acc[i] % p);
+        if (lead == 0) continue;
+        coeff_type const c = mul(lead, inv_lead);
+        q.coeffs[i - db] = c;
+        Utility::mul_add_row(acc.data() + (i - db), b.coeffs.data(), db, static_cast<std::uint16_t>(p - c));
+        if (++pending == rows)
         {
-            inp[0] = inp[1] = ' '; // delete "x^".
-            deg_type d;
-            istringstream iss_inp(inp);
-            if (iss_inp >> d) p += KPoly(K(1), d);
-            else is.setstate(std::ios_base::failbit);
+            for (size_t k = i - db; k < i; ++k) acc[k] %= p;
+            pending = 0;
         }
     }
-    return is;
+    a.coeffs.resize(db);
+    for (size_t k = 0; k < db; ++k) a.coeffs[k] = static_cast<coeff_type>(acc[k] % p);
+    a.normalize();
+    q.normalize();
+    return std::make_pair(std::move(q), std::move(a));
 }
 
-} // namespace Modulus
+template <unsigned p, typename deg_type> inline
+void Polynomial<Z<p>, deg_type>::divmod(Polynomial const & a, Polynomial const & b, Polynomial & q, Polynomial & r)
+{
+    auto qr_pair = divmod(a, b);
+    q = std::move(qr_pair.first);
+    r = std::move(qr_pair.second);
+}
+
+// IO streams //
+
+template <unsigned p, typename deg_type>
+std::ostream &
+Polynomial<Z<p>, deg_type>::write(std::ostream & o, Polynomial const & q)
+{
+    if (q.is_zero()) return o << Z<p>();
+    
+    size_t i = q.coeffs.size() - 1;
+    o << monom_string(std::make_pair(static_cast<deg_type>(i), q.at(i)));
+    while (i-- > 0)
+        if (q.coeffs[i] != 0) o << " + " << monom_string(std::make_pair(static_cast<deg_type>(i), q.at(i)));
+    return o;
+}
+
+template <unsigned p, typename deg_type>
+std::istream &
+Polynomial<Z<p>, deg_type>::read(std::istream & i, Polynomial & q)
+{
+    q = Polynomial();
+    
+    std::string inp;
+    if (i >> inp)
+    {
+        char const * first = inp.data();
+        if (not parse(first, first + inp.size(), q) or first != inp.data() + inp.size()) i.setstate(std::ios_base::failbit);
+    }
+    return i;
+}
 
+template <unsigned p, typename deg_type>
+bool Polynomial<Z<p>, deg_type>::parse(char const * & first, char const * last, Polynomial & q)
+{
+    q = Polynomial();
+    bool const ok = Utility::parse_polynomial(first, last, K::modulus(), [&q](size_t d, std::uint64_t a)
+    {
+        if (q.coeffs.size() <= d) q.coeffs.resize(d + 1);
+        q.coeffs[d] = add(q.coeffs[d], static_cast<coeff_type>(a));
+    });
+    q.normalize();
+    return ok;
+}
+
+// Hash //
+
+template <unsigned p, typename deg_type>
+size_t Polynomial<Z<p>, deg_type>::hash() const noexcept
+{
+    size_t res = coeffs.size();
+    for (coeff_type c : coeffs) res ^= c + 0x9e3779b97f4a7c15ull + (res << 6) + (res >> 2);
+    return res;
+}
+
+} // namespace Modulus
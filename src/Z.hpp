@@ -23,6 +23,7 @@
  */
 
 #include <iostream>
+#include <cstdint>
 
 namespace Modulus
 {
@@ -46,6 +47,39 @@ long ext_euclid(long a, long b, long & u, long & v) noexcept
     return a;
 }
 
+/// Whether n is a prime number, by trial division.
+constexpr bool is_prime(unsigned n) noexcept
+{
+    if (n < 2) return false;
+    for (unsigned d = 2; d <= n / d; ++d) if (n % d == 0) return false;
+    return true;
+}
+
+/// The multiplicative inverses of Z/pZ for small p, built at compile time.
+/// inverse[a] is the inverse of a, or 0 for zero divisors.
+/// Compile with -DMODULUS_NO_TABLES to use the extended Euclidean algorithm for every p, e. g. for comparison.
+template<unsigned p>
+struct InverseTable
+{
+    static constexpr unsigned max_p   = 0x100u;
+#ifdef MODULUS_NO_TABLES
+    static constexpr bool     enabled = false;
+#else
+    static constexpr bool     enabled = p <= max_p;
+#endif
+
+    unsigned char inverse[enabled ? p : 1] = { };
+
+    constexpr InverseTable()
+    {
+        for (unsigned a = 1; enabled and a < p; ++a)
+        {
+            long u = 0, v = 0;
+            if (ext_euclid(a, p, u, v) == 1) inverse[a] = static_cast<unsigned char>((u % static_cast<long>(p) + p) % p);
+        }
+    }
+};
+
 /// For any p > 0, Z<p> objects represent numbers of Z/pZ. They aim to behave like these.
 /// If you divide through some zero divisor, the result will be zero; without exception being thrown.
 template<unsigned p>
@@ -64,11 +98,15 @@ private:
         return (n %= static_cast<signed>(p)) < 0  ?  p + n  :  n;
     }
     
+    static constexpr InverseTable<p> inverses { };
+
     /// Returns the multimlicative inverse of the Z object.
     /// Those inverses don't exist for zero divisors; those will be mapped to zero.
+    /// For small p the inverse is looked up in a table instead.
     friend constexpr
     Z inv(Z z)
     {
+        if (InverseTable<p>::enabled) return Z(inverses.inverse[z.x], true);
         long inverse = 0, dummy = 0;
         if (1 != ext_euclid(z.x, p, inverse, dummy)) return Z(0);
         return Z(static_cast<signed int>(inverse));
@@ -80,6 +118,12 @@ private:
     Z(unsigned x, bool) : x(x) { }
 
 public:
+    /// The modulus p.
+    static constexpr unsigned modulus() noexcept { return p; }
+
+    /// Reduces any 64 bit value, e. g. a product of two reduced values, modulo p.
+    static constexpr unsigned reduce_wide(std::uint64_t n) noexcept { return static_cast<unsigned>(n % p); }
+
             constexpr   Z(unsigned n = 0u) : x(n % p) {  }
             constexpr   Z(  signed n     ) : x(reduce(n)) {  }
 
@@ -88,11 +132,11 @@ public:
     friend  constexpr   bool operator !=(Z z1, Z z2) { return z1.x != z2.x; }
 
             constexpr   Z    operator + () const { return Z(x,     true); }
-            constexpr   Z    operator - () const { return Z(p - x, true); }
+            constexpr   Z    operator - () const { return Z(x == 0 ? 0 : p - x, true); }
 
-    friend  constexpr    Z    operator + (Z z1, Z z2) { return Z(z1.x + z2.x); }
+    friend  constexpr    Z    operator + (Z z1, Z z2) { return Z(z1.x + z2.x >= p ? z1.x + z2.x - p : z1.x + z2.x, true); }
     friend  constexpr    Z    operator - (Z z1, Z z2) { return z1 + (-z2); }
-    friend  constexpr    Z    operator * (Z z1, Z z2) { return Z(z1.x * z2.x); }
+    friend  constexpr    Z    operator * (Z z1, Z z2) { return Z(reduce_wide(static_cast<std::uint64_t>(z1.x) * z2.x), true); }
     friend  constexpr    Z    operator / (Z z1, Z z2) { return z1 * inv(z2); }
 
             constexpr    Z &  operator +=(Z const & z) { return *this = *this + z; }
@@ -111,6 +155,9 @@ public:
     constexpr explicit operator unsigned() const { return x; }
 };
 
+template<unsigned p>
+constexpr InverseTable<p> Z<p>::inverses;
+
 template<>
 class Z<2>
 {
@@ -122,6 +169,9 @@ private:
     constexpr Z(unsigned n, bool) : x(n) {  }
 
 public:
+    static constexpr unsigned modulus() noexcept { return 2; }
+    static constexpr unsigned reduce_wide(std::uint64_t n) noexcept { return n & 1u; }
+
     constexpr Z(unsigned n = 0u) : x(n & 1u)    {  }
     constexpr Z(  signed n)      : x(n & 1 )    {  }
     constexpr Z(bool     n)      : x(n ? 1 : 0) {  }
@@ -154,6 +204,91 @@ public:
     constexpr explicit operator unsigned() const noexcept { return x; }
 };
 
+/// Z<0> represents the numbers of Z/qZ for a modulus q chosen at runtime by Z<0>::set_modulus(q), with 1 < q < 2^31.
+/// It serves the primes without a compile time specialization. The modulus is global, so it must be set before any Z<0> object is used.
+/// Products are reduced by Barrett reduction: with m = floor((2^64 - 1) / q), floor(n * m / 2^64) is floor(n / q) or one less
+/// for any n < q^2 < 2^62, so a multiplication and one conditional subtraction replace the division.
+template<>
+class Z<0>
+{
+private:
+    unsigned x;
+
+    struct Params
+    {
+        std::uint64_t q;
+        std::uint64_t m;
+    };
+
+    static Params & params() noexcept
+    {
+        static Params par = { 2, ~std::uint64_t(0) / 2 };
+        return par;
+    }
+
+    /// Reduces the signed value modulo q.
+    static unsigned reduce(long n) noexcept
+    {
+        long const q = static_cast<long>(modulus());
+        return static_cast<unsigned>((n %= q) < 0 ? q + n : n);
+    }
+
+    /// Fast unsafe constructor (with blind parameter).
+    /// Used when caller can prove that x % q == x.
+    Z(unsigned x, bool) : x(x) { }
+
+    friend Z inv(Z z)
+    {
+        long inverse = 0, dummy = 0;
+        if (1 != ext_euclid(z.x, modulus(), inverse, dummy)) return Z(0);
+        return Z(static_cast<signed int>(inverse));
+    }
+
+public:
+    static void set_modulus(unsigned q) noexcept { params() = { q, ~std::uint64_t(0) / q }; }
+
+    static unsigned modulus() noexcept { return static_cast<unsigned>(params().q); }
+
+    /// Reduces n < q^2 modulo q, e. g. a product of two reduced values.
+    static unsigned reduce_wide(std::uint64_t n) noexcept
+    {
+        Params const & par = params();
+        std::uint64_t const quot = static_cast<std::uint64_t>((static_cast<unsigned __int128>(n) * par.m) >> 64);
+        std::uint64_t const r    = n - quot * par.q;
+        return static_cast<unsigned>(r >= par.q ? r - par.q : r);
+    }
+
+    Z(unsigned n = 0u) : x(n % modulus()) {  }
+    Z(  signed n     ) : x(reduce(n)) {  }
+
+    friend  bool operator ==(Z z1, Z z2) { return z1.x == z2.x; }
+    friend  bool operator < (Z z1, Z z2) { return z1.x <  z2.x; }
+    friend  bool operator !=(Z z1, Z z2) { return z1.x != z2.x; }
+
+            Z    operator + () const { return Z(x, true); }
+            Z    operator - () const { return Z(x == 0 ? 0 : modulus() - x, true); }
+
+    friend  Z    operator + (Z z1, Z z2) { unsigned const s = z1.x + z2.x;  return Z(s >= modulus() ? s - modulus() : s, true); }
+    friend  Z    operator - (Z z1, Z z2) { return z1 + (-z2); }
+    friend  Z    operator * (Z z1, Z z2) { return Z(reduce_wide(static_cast<std::uint64_t>(z1.x) * z2.x), true); }
+    friend  Z    operator / (Z z1, Z z2) { return z1 * inv(z2); }
+
+            Z &  operator +=(Z const & z) { return *this = *this + z; }
+            Z &  operator -=(Z const & z) { return *this = *this - z; }
+            Z &  operator *=(Z const & z) { return *this = *this * z; }
+            Z &  operator /=(Z const & z) { return *this = *this / z; }
+
+            Z    operator ++(   ) { if (++x == modulus()) x = 0;   return *this; }
+            Z    operator --(   ) { if (x-- == 0) x = modulus()-1; return *this; }
+            Z    operator ++(int) { Z res = *this; ++(*this); return res; }
+            Z    operator --(int) { Z res = *this; --(*this); return res; }
+
+    friend  std::ostream & operator <<(std::ostream & os, Z const & z) { return os << z.x; }
+    friend  std::istream & operator >>(std::istream & is, Z       & z) { long x;  is >> x;  z = Z(reduce(x), true);  return is; }
+
+    explicit operator unsigned() const { return x; }
+};
+
 } // namespace Modulus
 
 namespace std
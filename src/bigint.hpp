@@ -0,0 +1,184 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no bigint.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// Multiplication of non-negative integers given as arrays of 64-bit words, least significant word first,
+// and the Kronecker substitution, which maps polynomials with small coefficients to such integers.
+// A polynomial sum c[i] x^i is packed as the integer sum c[i] 2^(bits i); if every coefficient of the product is below 2^bits,
+// the product of the integers holds the coefficients of the product polynomial in its bits-bit slots.
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+namespace Modulus { namespace Utility
+{
+
+using bigword = std::uint64_t;
+
+// Number of words below which bigmul multiplies by schoolbook.
+inline std::size_t & bigmul_karatsuba_threshold() noexcept
+{
+    static std::size_t threshold = 32;
+    return threshold;
+}
+
+// r[0 .. na + nb) = a[0 .. na) * b[0 .. nb) by schoolbook; r must be zeroed by the caller.
+inline void bigmul_schoolbook(bigword * r, bigword const * a, std::size_t na, bigword const * b, std::size_t nb) noexcept
+{
+    for (std::size_t i = 0; i < na; ++i)
+    {
+        if (a[i] == 0) continue;
+        bigword carry = 0;
+        for (std::size_t j = 0; j < nb; ++j)
+        {
+            unsigned __int128 const t = static_cast<unsigned __int128>(a[i]) * b[j] + r[i + j] + carry;
+            r[i + j] = static_cast<bigword>(t);
+            carry    = static_cast<bigword>(t >> 64);
+        }
+        r[i + nb] = carry;
+    }
+}
+
+// r[0 .. n) += a[0 .. n); returns the carry.
+inline bigword bigadd(bigword * r, bigword const * a, std::size_t n) noexcept
+{
+    bigword carry = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        bigword const s = r[i] + carry;
+        carry = s < carry;
+        r[i]  = s + a[i];
+        carry += r[i] < s;
+    }
+    return carry;
+}
+
+// r[0 .. n) -= a[0 .. n); returns the borrow.
+inline bigword bigsub(bigword * r, bigword const * a, std::size_t n) noexcept
+{
+    bigword borrow = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        bigword const d = r[i] - borrow;
+        borrow = d > r[i];
+        borrow += d < a[i];
+        r[i]  = d - a[i];
+    }
+    return borrow;
+}
+
+// Propagates carry into r[0 .. n).
+inline void bigcarry(bigword * r, std::size_t n, bigword carry) noexcept
+{
+    for (std::size_t i = 0; carry != 0 and i < n; ++i) carry = (r[i] += carry) < carry;
+}
+
+// Propagates borrow out of r[0 .. n).
+inline void bigborrow(bigword * r, std::size_t n, bigword borrow) noexcept
+{
+    for (std::size_t i = 0; borrow != 0 and i < n; ++i) { bigword const d = r[i] - borrow;  borrow = d > r[i];  r[i] = d; }
+}
+
+// r[0 .. 2n) = a[0 .. n) * b[0 .. n) by Karatsuba's method, (a1 t + a0)(b1 t + b0) = a1 b1 t^2 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) t + a0 b0.
+// r must be zeroed by the caller; scratch must hold 8n + 64 words.
+inline void bigmul_karatsuba(bigword * r, bigword const * a, bigword const * b, std::size_t n, bigword * scratch) noexcept
+{
+    if (n < std::max<std::size_t>(4, bigmul_karatsuba_threshold())) { bigmul_schoolbook(r, a, n, b, n);  return; }
+
+    std::size_t const m = n / 2,
+                      h = n - m;
+    bigmul_karatsuba(r,         a,     b,     m, scratch);
+    bigmul_karatsuba(r + 2 * m, a + m, b + m, h, scratch);
+
+    bigword * sa = scratch,
+            * sb = sa + (h + 1),
+            * pr = sb + (h + 1),
+            * next = pr + 2 * (h + 1);
+    std::copy(a + m, a + n, sa);  sa[h] = 0;
+    std::copy(b + m, b + n, sb);  sb[h] = 0;
+    bigcarry(sa + m, h + 1 - m, bigadd(sa, a, m));
+    bigcarry(sb + m, h + 1 - m, bigadd(sb, b, m));
+    std::fill(pr, next, bigword(0));
+    bigmul_karatsuba(pr, sa, sb, h + 1, next);
+
+    bigborrow(pr + 2 * m, 2 * (h + 1) - 2 * m, bigsub(pr, r, 2 * m));
+    bigborrow(pr + 2 * h, 2,                   bigsub(pr, r + 2 * m, 2 * h));
+    bigcarry(r + m + 2 * (h + 1), 2 * n - m - 2 * (h + 1), bigadd(r + m, pr, 2 * (h + 1)));
+}
+
+// r[0 .. na + nb) = a[0 .. na) * b[0 .. nb); r must be zeroed by the caller.
+// Long factors are multiplied in blocks of the length of the shorter one, each by Karatsuba's method.
+inline void bigmul(bigword * r, bigword const * a, std::size_t na, bigword const * b, std::size_t nb)
+{
+    if (na < nb) { std::swap(a, b);  std::swap(na, nb); }
+    if (nb < bigmul_karatsuba_threshold()) { bigmul_schoolbook(r, a, na, b, nb);  return; }
+
+    std::vector<bigword> block(nb, 0), prod(2 * nb), scratch(8 * nb + 64);
+    for (std::size_t i = 0; i < na; i += nb)
+    {
+        std::size_t const len = std::min(nb, na - i);
+        std::copy(a + i, a + i + len, block.begin());
+        std::fill(block.begin() + len, block.end(), bigword(0));
+        std::fill(prod.begin(), prod.end(), bigword(0));
+        bigmul_karatsuba(prod.data(), block.data(), b, nb, scratch.data());
+
+        std::size_t const n = std::min(2 * nb, na + nb - i);
+        bigcarry(r + i + n, na + nb - i - n, bigadd(r + i, prod.data(), n));
+    }
+}
+
+// Packs c[0 .. n) into slots of bits <= 64 bits each; r must be zeroed by the caller and hold (n bits + 63) / 64 words.
+template <typename T>
+void kronecker_pack(bigword * r, T const * c, std::size_t n, unsigned bits) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        bigword const v   = c[i];
+        std::size_t const pos = i * bits;
+        r[pos / 64] |= v << (pos % 64);
+        if (pos % 64 != 0 and pos % 64 + bits > 64) r[pos / 64 + 1] |= v >> (64 - pos % 64);
+    }
+}
+
+// Returns slot i of width bits <= 64 of r.
+inline bigword kronecker_slot(bigword const * r, std::size_t i, unsigned bits) noexcept
+{
+    std::size_t const pos = i * bits;
+    bigword v = r[pos / 64] >> (pos % 64);
+    if (pos % 64 != 0 and pos % 64 + bits > 64) v |= r[pos / 64 + 1] << (64 - pos % 64);
+    return bits == 64 ? v : v & ((bigword(1) << bits) - 1);
+}
+
+// The slot width for the product of polynomials with coefficients < p and the shorter one having n coefficients,
+// i. e. the number of bits of n (p - 1)^2. Returns 65 if it exceeds 64 bits.
+inline unsigned kronecker_bits(std::uint64_t p, std::size_t n) noexcept
+{
+    unsigned __int128 const bound = static_cast<unsigned __int128>((p - 1) * (p - 1)) * n;
+    unsigned bits = 1;
+    while (bits <= 64 and (bound >> bits) != 0) ++bits;
+    return bits;
+}
+
+}} // namespace Modulus::Utility
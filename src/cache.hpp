@@ -0,0 +1,148 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rank_sieve.hpp"
+
+namespace Modulus
+{
+
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+
+// On-disk cache of the irreducible polynomials of the RankSieve, one file per (p, degree) in a directory.
+// A file is a CacheHeader followed by the words of the RankBitset of the irreducible polynomials, in the byte order of the machine.
+// Files are memory-mapped copy-on-write on load, so a cached degree costs no more than paging in its bits.
+// A file with another magic, version, p, degree or size, or a wrong checksum, is ignored and overwritten by the next store.
+constexpr char     cache_magic[8] = { 'M', 'O', 'D', 'I', 'R', 'R', 'B', 'S' };
+constexpr uint32_t cache_version   = 1;
+
+struct CacheHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t p;
+    uint32_t degree;
+    uint32_t reserved;
+    uint64_t bits;
+    uint64_t count;     // number of set bits
+    uint64_t checksum;  // checksum_words of the words
+};
+
+namespace Utility
+{
+
+// 64 bit FNV-1a over the words.
+inline uint64_t checksum_words(uint64_t const * words, uint64_t n)
+{
+    uint64_t h = 0xcbf29ce484222325u;
+    for (uint64_t k = 0; k < n; ++k) h = (h ^ words[k]) * 0x100000001b3u;
+    return h;
+}
+
+} // namespace Utility
+
+class SieveCache
+{
+public:
+    // Creates the directory if it does not exist yet.
+    explicit SieveCache(string dir) : dir(std::move(dir)) { ::mkdir(this->dir.c_str(), 0777); }
+
+    string const & directory() const { return dir; }
+
+    string file(unsigned p, unsigned d) const { return dir + "/irreducible_p" + std::to_string(p) + "_d" + std::to_string(d) + ".bin"; }
+
+    // Maps the irreducible polynomials of degree d modulo p into marks.
+    // Returns false if there is no valid file for them, marks is unchanged then.
+    bool load(unsigned p, unsigned d, RankBitset & marks) const
+    {
+        uint64_t bits = 1;
+        for (unsigned k = 0; k < d; ++k) bits *= p;
+        uint64_t const words = (bits + 63) / 64,
+                       bytes = sizeof(CacheHeader) + words * sizeof(uint64_t);
+
+        int const fd = ::open(file(p, d).c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        void * addr = MAP_FAILED;
+        if (::fstat(fd, &st) == 0 and static_cast<uint64_t>(st.st_size) == bytes)
+            addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) return false;
+        std::shared_ptr<void> mapping(addr, [bytes](void * a) { ::munmap(a, bytes); });
+
+        auto const & header = *static_cast<CacheHeader const *>(addr);
+        auto       * data   = reinterpret_cast<uint64_t *>(static_cast<char *>(addr) + sizeof(CacheHeader));
+        if (std::memcmp(header.magic, cache_magic, sizeof cache_magic) != 0 or header.version != cache_version or
+            header.p != p or header.degree != d or header.bits != bits or
+            header.checksum != Utility::checksum_words(data, words)) return false;
+
+        marks = RankBitset(std::move(mapping), data, bits);
+        return true;
+    }
+
+    // Writes the irreducible polynomials of degree d modulo p. The file is replaced atomically, so concurrent runs never see a partial file.
+    // Returns false if the file could not be written.
+    bool store(unsigned p, unsigned d, RankBitset const & marks) const
+    {
+        uint64_t const words = (marks.size() + 63) / 64;
+        CacheHeader header;
+        std::memcpy(header.magic, cache_magic, sizeof cache_magic);
+        header.version  = cache_version;
+        header.p        = p;
+        header.degree   = d;
+        header.reserved = 0;
+        header.bits     = marks.size();
+        header.count    = marks.count();
+        header.checksum = Utility::checksum_words(marks.data(), words);
+
+        string const name = file(p, d),
+                     tmp  = name + ".tmp" + std::to_string(::getpid());
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<char const *>(&header), sizeof header);
+            out.write(reinterpret_cast<char const *>(marks.data()), words * sizeof(uint64_t));
+            // The final flush happens on close, so a full disk only shows up there.
+            out.close();
+            if (out.fail()) { std::remove(tmp.c_str());  return false; }
+        }
+        return std::rename(tmp.c_str(), name.c_str()) == 0;
+    }
+
+private:
+    string dir;
+};
+
+} // namespace Modulus
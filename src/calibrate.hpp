@@ -0,0 +1,213 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no calibrate.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// Measurement of the crossovers between the multiplication tiers on the running machine.
+// A tier is taken from the smallest size on at which it beats the tier below at two consecutive sizes.
+
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "clmul.hpp"
+#include "reduction.hpp"
+
+namespace Modulus
+{
+
+namespace Utility
+{
+
+// Nanoseconds per call of func, repeated for about 2 ms.
+template <typename Func>
+double time_per_call(Func && func)
+{
+    using clock = std::chrono::steady_clock;
+    size_t     calls = 0;
+    auto const start = clock::now();
+    auto       now   = start;
+    do
+    {
+        func();
+        ++calls;
+        now = clock::now();
+    }
+    while (now - start < std::chrono::milliseconds(2));
+    return std::chrono::duration<double, std::nano>(now - start).count() / calls;
+}
+
+// Returns the smallest size of sizes at which faster(n) holds for n and the next size, or max() if there is none.
+template <typename Faster>
+size_t first_crossover(std::vector<size_t> const & sizes, Faster && faster)
+{
+    for (size_t i = 0; i + 1 < sizes.size(); ++i)
+        if (faster(sizes[i]) and faster(sizes[i + 1])) return sizes[i];
+    return std::numeric_limits<size_t>::max();
+}
+
+// 8, 12, 16, 24, 32, ... up to max_n.
+inline std::vector<size_t> calibration_sizes(size_t max_n)
+{
+    std::vector<size_t> sizes;
+    for (size_t n = 8; n <= max_n; n *= 2)
+    {
+        sizes.push_back(n);
+        if (n + n / 2 <= max_n) sizes.push_back(n + n / 2);
+    }
+    return sizes;
+}
+
+} // namespace Utility
+
+// Measures the thresholds of Polynomial<Z<p>> for factors of up to max_n coefficients, stores and returns them.
+// The Kronecker tier depends on the integer multiplication, so calibrate_bigmul should run before.
+// For p = 0 the modulus must be set already.
+template <unsigned p>
+MulThresholds calibrate_multiplication(size_t max_n = 16384)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+    size_t const never = std::numeric_limits<size_t>::max();
+
+    std::mt19937 rng(12345);
+    auto random_poly = [&rng](size_t n)
+    {
+        std::vector<K> coeffs(n);
+        for (auto & c : coeffs) c = K(static_cast<unsigned>(rng() % K::modulus()));
+        coeffs.back() = K(1);
+        return KPoly::fromCoeffVector(coeffs);
+    };
+    auto time_with = [&](size_t n, MulThresholds t)
+    {
+        KPoly const f = random_poly(n), g = random_poly(n);
+        mul_thresholds<p>() = t;
+        size_t volatile sink = 0;
+        return Utility::time_per_call([&] { sink = sink + deg(f * g); });
+    };
+
+    std::vector<size_t> const sizes = Utility::calibration_sizes(max_n);
+
+    // One level of Karatsuba at n, i. e. with threshold n, against schoolbook.
+    MulThresholds res = { never, never, never };
+    res.karatsuba = Utility::first_crossover(sizes, [&](size_t n)
+        {
+            return time_with(n, { n, never, never }) < time_with(n, { never, never, never });
+        });
+    res.kronecker = Utility::first_crossover(sizes, [&](size_t n)
+        {
+            return Utility::kronecker_bits(K::modulus(), n) <= 64
+               and time_with(n, { res.karatsuba, n, never }) < time_with(n, { res.karatsuba, never, never });
+        });
+    res.ntt = Utility::first_crossover(sizes, [&](size_t n)
+        {
+            return time_with(n, { res.karatsuba, res.kronecker, n }) < time_with(n, { res.karatsuba, res.kronecker, never });
+        });
+    return mul_thresholds<p>() = res;
+}
+
+// Measures the degree of the modulus from which Reducer<p> uses Newton inversion, for degrees up to max_n; stores and returns it.
+// The multiplication thresholds should be calibrated before.
+template <unsigned p>
+size_t calibrate_reduction(size_t max_n = 32768)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+    size_t const never = std::numeric_limits<size_t>::max();
+
+    std::mt19937 rng(12345);
+    auto random_poly = [&rng](size_t n)
+    {
+        std::vector<K> coeffs(n);
+        for (auto & c : coeffs) c = K(static_cast<unsigned>(rng() % K::modulus()));
+        coeffs.back() = K(1);
+        return KPoly::fromCoeffVector(coeffs);
+    };
+    auto time_with = [&](size_t n, size_t threshold)
+    {
+        KPoly const f = random_poly(n + 1), a = random_poly(2 * n - 1);
+        Reducer<p>::newton_threshold() = threshold;
+        Reducer<p> const red(f);
+        size_t volatile sink = 0;
+        return Utility::time_per_call([&] { sink = sink + deg(red.reduce(a)); });
+    };
+
+    return Reducer<p>::newton_threshold() = Utility::first_crossover(Utility::calibration_sizes(max_n), [&](size_t n)
+        {
+            return time_with(n, n) < time_with(n, never);
+        });
+}
+
+// Measures the Karatsuba threshold of the integer multiplication in words of up to max_words, stores and returns it.
+inline size_t calibrate_bigmul(size_t max_words = 512)
+{
+    size_t const never = std::numeric_limits<size_t>::max();
+
+    std::mt19937_64 rng(12345);
+    auto time_with = [&](size_t n, size_t threshold)
+    {
+        std::vector<Utility::bigword> a(n), b(n), r(2 * n);
+        for (auto & w : a) w = rng();
+        for (auto & w : b) w = rng();
+        Utility::bigmul_karatsuba_threshold() = threshold;
+        return Utility::time_per_call([&]
+            {
+                std::fill(r.begin(), r.end(), Utility::bigword(0));
+                Utility::bigmul(r.data(), a.data(), n, b.data(), n);
+            });
+    };
+
+    return Utility::bigmul_karatsuba_threshold() = Utility::first_crossover(Utility::calibration_sizes(max_words), [&](size_t n)
+        {
+            return time_with(n, n) < time_with(n, never);
+        });
+}
+
+// Measures the Karatsuba threshold of the GF(2) multiplication in words of up to max_words, stores and returns it.
+inline size_t calibrate_clmul(size_t max_words = 512)
+{
+    size_t const never = std::numeric_limits<size_t>::max();
+
+    std::mt19937_64 rng(12345);
+    auto time_with = [&](size_t n, size_t threshold)
+    {
+        std::vector<Utility::word> a(n), b(n), r(2 * n);
+        for (auto & w : a) w = rng();
+        for (auto & w : b) w = rng();
+        Utility::clmul_karatsuba_threshold() = threshold;
+        return Utility::time_per_call([&]
+            {
+                std::fill(r.begin(), r.end(), Utility::word(0));
+                Utility::clmul_multiply(r.data(), a.data(), n, b.data(), n);
+            });
+    };
+
+    return Utility::clmul_karatsuba_threshold() = Utility::first_crossover(Utility::calibration_sizes(max_words), [&](size_t n)
+        {
+            return time_with(n, n) < time_with(n, never);
+        });
+}
+
+} // namespace Modulus
@@ -0,0 +1,184 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no clmul.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// Carry-less (i. e. (Z/2Z)[x]) multiplication of 64-bit words and of word arrays.
+// Bit i of a word is the coefficient of x^i; word k of an array holds the coefficients of x^(64k) ... x^(64k + 63).
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "cpu.hpp"
+
+#ifdef MODULUS_X86_TARGETS
+#include <wmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+namespace Modulus { namespace Utility
+{
+
+using word = std::uint64_t;
+
+// Index of the highest set bit of w; w must not be zero.
+inline unsigned top_bit(word w) noexcept
+{
+#if defined(__GNUC__) or defined(__clang__)
+    return 63 - __builtin_clzll(w);
+#else
+    unsigned i = 0;
+    while (w >>= 1) ++i;
+    return i;
+#endif
+}
+
+// Portable carry-less product a * b = hi * x^64 + lo using a 4-bit window.
+inline void clmul_portable(word a, word b, word & lo, word & hi) noexcept
+{
+    // The table entries are a * i for all i < 16. These have up to 67 bits, so the top 3 bits go to tab_hi.
+    word tab_lo[16], tab_hi[16];
+    tab_lo[0] = tab_hi[0] = 0;
+    tab_lo[1] = a;  tab_hi[1] = 0;
+    for (unsigned i = 2; i < 16; i += 2)
+    {
+        tab_lo[i]     = tab_lo[i / 2] << 1;
+        tab_hi[i]     = tab_hi[i / 2] << 1 | tab_lo[i / 2] >> 63;
+        tab_lo[i + 1] = tab_lo[i] ^ a;
+        tab_hi[i + 1] = tab_hi[i];
+    }
+
+    lo = tab_lo[b & 15];
+    hi = tab_hi[b & 15];
+    for (unsigned s = 4; s < 64; s += 4)
+    {
+        unsigned const n = (b >> s) & 15;
+        lo ^= tab_lo[n] << s;
+        hi ^= tab_lo[n] >> (64 - s)  ^  tab_hi[n] << s;
+    }
+}
+
+// r[0 .. na + nb) = a[0 .. na) * b[0 .. nb); r must be zeroed by the caller.
+inline void clmul_words_portable(word * r, word const * a, size_t na, word const * b, size_t nb) noexcept
+{
+    for (size_t i = 0; i < na; ++i)
+    {
+        if (a[i] == 0) continue;
+        for (size_t j = 0; j < nb; ++j)
+        {
+            word lo, hi;
+            clmul_portable(a[i], b[j], lo, hi);
+            r[i + j]     ^= lo;
+            r[i + j + 1] ^= hi;
+        }
+    }
+}
+
+#ifdef MODULUS_X86_TARGETS
+// Same as clmul_words_portable using the PCLMULQDQ instruction. Only call if cpu_has_pclmul().
+__attribute__((target("pclmul,sse2")))
+inline void clmul_words_pclmul(word * r, word const * a, size_t na, word const * b, size_t nb) noexcept
+{
+    for (size_t i = 0; i < na; ++i)
+    {
+        if (a[i] == 0) continue;
+        __m128i const ai = _mm_cvtsi64_si128(static_cast<long long>(a[i]));
+        for (size_t j = 0; j < nb; ++j)
+        {
+            __m128i const prod = _mm_clmulepi64_si128(ai, _mm_cvtsi64_si128(static_cast<long long>(b[j])), 0x00);
+            r[i + j]     ^= static_cast<word>(_mm_cvtsi128_si64(prod));
+            r[i + j + 1] ^= static_cast<word>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(prod, prod)));
+        }
+    }
+}
+#endif
+
+// r[0 .. na + nb) = a[0 .. na) * b[0 .. nb); r must be zeroed by the caller.
+// Uses PCLMULQDQ if the CPU has it, the portable version otherwise.
+inline void clmul_words(word * r, word const * a, size_t na, word const * b, size_t nb) noexcept
+{
+#ifdef MODULUS_X86_TARGETS
+    if (cpu_has_pclmul()) { clmul_words_pclmul(r, a, na, b, nb); return; }
+#endif
+    clmul_words_portable(r, a, na, b, nb);
+}
+
+// Number of words of the shorter factor from which clmul_multiply uses Karatsuba's method.
+// The GF(2) polynomials are already packed into machine words, so there is no Kronecker tier for them.
+inline size_t & clmul_karatsuba_threshold() noexcept
+{
+    static size_t threshold = 32;
+    return threshold;
+}
+
+// r[0 .. 2n) = a[0 .. n) * b[0 .. n) by Karatsuba's method, where additions are XORs.
+// r must be zeroed by the caller; scratch must hold 4n + 64 words.
+inline void clmul_karatsuba(word * r, word const * a, word const * b, size_t n, word * scratch) noexcept
+{
+    if (n < std::max<size_t>(2, clmul_karatsuba_threshold())) { clmul_words(r, a, n, b, n);  return; }
+
+    size_t const m = n / 2,
+                 h = n - m;
+    clmul_karatsuba(r,         a,     b,     m, scratch);
+    clmul_karatsuba(r + 2 * m, a + m, b + m, h, scratch);
+
+    word * sa   = scratch,
+         * sb   = sa + h,
+         * pr   = sb + h,
+         * next = pr + 2 * h;
+    for (size_t i = 0; i < h; ++i)
+    {
+        sa[i] = a[m + i] ^ (i < m ? a[i] : 0);
+        sb[i] = b[m + i] ^ (i < m ? b[i] : 0);
+    }
+    for (size_t i = 0; i < 2 * h; ++i) pr[i] = 0;
+    clmul_karatsuba(pr, sa, sb, h, next);
+
+    for (size_t i = 0; i < 2 * m; ++i) pr[i] ^= r[i];
+    for (size_t i = 0; i < 2 * h; ++i) pr[i] ^= r[2 * m + i];
+    for (size_t i = 0; i < 2 * h; ++i) r[m + i] ^= pr[i];
+}
+
+// r[0 .. na + nb) = a[0 .. na) * b[0 .. nb); r must be zeroed by the caller.
+// Uses Karatsuba's method on blocks of the length of the shorter factor if that is long enough, clmul_words otherwise.
+inline void clmul_multiply(word * r, word const * a, size_t na, word const * b, size_t nb)
+{
+    if (na < nb) { std::swap(a, b);  std::swap(na, nb); }
+    if (nb < clmul_karatsuba_threshold()) { clmul_words(r, a, na, b, nb);  return; }
+
+    std::vector<word> block(nb), prod(2 * nb), scratch(4 * nb + 64);
+    for (size_t i = 0; i < na; i += nb)
+    {
+        size_t const len = std::min(nb, na - i);
+        std::copy(a + i, a + i + len, block.begin());
+        std::fill(block.begin() + len, block.end(), word(0));
+        std::fill(prod.begin(), prod.end(), word(0));
+        clmul_karatsuba(prod.data(), block.data(), b, nb, scratch.data());
+
+        size_t const n = std::min(2 * nb, na + nb - i);
+        for (size_t k = 0; k < n; ++k) r[i + k] ^= prod[k];
+    }
+}
+
+}} // namespace Modulus::Utility
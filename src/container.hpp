@@ -23,6 +23,7 @@
  */
 
 #include <sstream>
+#include <vector>
 
 namespace Modulus
 {
@@ -81,10 +82,11 @@ bool iterator_multi_increment(std::vector<Iterator>       & itrs,
 }
 
 // Increments the vector of iterators in reverse p-aric style, but respecting equalness of startpoints and commutativity of pointed values.
+// Returns the number of leading iterators which changed, i. e. itrs[k] for k >= the result are as before. On overflow the result is 0.
 template<typename Iterator>
-bool iterator_multi_increment_delta(std::vector<Iterator>       & itrs,
-                                    std::vector<Iterator> const & begs,
-                                    std::vector<Iterator> const & ends)
+size_t iterator_multi_increment_delta_count(std::vector<Iterator>       & itrs,
+                                            std::vector<Iterator> const & begs,
+                                            std::vector<Iterator> const & ends)
 {
     // Here we use that the degree of the polynomials any of itrs is pointing at is fixed and that for i = 0, ..., n, deg(*(itrs[i])) is weakly increasing.
     // Therefore, and because multimplcation is commutative on polynomials over fields, we can take the previous iterator as beginning iff they iterate the same vector.
@@ -94,13 +96,61 @@ bool iterator_multi_increment_delta(std::vector<Iterator>       & itrs,
         {
             size_t j = 0;
             while (i > j and begs[i - ++j] == begs[i]) itrs[i-j] = itrs[i];
-            return true;
+            return i + 1;
         }
         itrs[i] = begs[i];
     }
     // if we come here, we know: every iterator has been reset.
     // therefore we signalize no further iterating.
-    return false;
+    return 0;
+}
+
+// Increments the vector of iterators in reverse p-aric style, but respecting equalness of startpoints and commutativity of pointed values.
+// On overflow the function returns false, in any other case the result is true.
+template<typename Iterator>
+bool iterator_multi_increment_delta(std::vector<Iterator>       & itrs,
+                                    std::vector<Iterator> const & begs,
+                                    std::vector<Iterator> const & ends)
+{
+    return iterator_multi_increment_delta_count(itrs, begs, ends) != 0;
 }
 
+// The products *itrs[0] * ... * *itrs[n-1] along the iteration of iterator_multi_increment_delta over [begs[i], ends[i]).
+// As the iteration mostly moves the first iterators only, the products of the trailing factors are cached:
+// suffix[k] is the product of *itrs[k], ..., *itrs[n-1]. A step which changes the first m iterators costs m multiplications.
+template<typename T, typename Iterator>
+class MultiIncrementProduct
+{
+public:
+    MultiIncrementProduct(std::vector<Iterator> const & begs,
+                          std::vector<Iterator> const & ends,
+                          T                     const & one)
+        : itrs(begs), begs(begs), ends(ends), suffix(begs.size() + 1, one)
+    {
+        update(itrs.size());
+    }
+
+    T                     const & product()   const { return suffix.front(); }
+    std::vector<Iterator> const & iterators() const { return itrs; }
+
+    // Moves to the next combination; returns false after the last one.
+    bool next()
+    {
+        size_t const changed = iterator_multi_increment_delta_count(itrs, begs, ends);
+        update(changed);
+        return changed != 0;
+    }
+
+private:
+    std::vector<Iterator>         itrs;
+    std::vector<Iterator> const & begs;
+    std::vector<Iterator> const & ends;
+    std::vector<T>                suffix;
+
+    void update(size_t changed)
+    {
+        for (size_t k = changed; k-- > 0; ) suffix[k] = *itrs[k] * suffix[k + 1];
+    }
+};
+
 } // namespace Modulus
@@ -0,0 +1,174 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no counters.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+
+#include "partition.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+using std::uint64_t;
+
+// Hot-path counters of the sieves, switched on at runtime by --stats.
+// Compiling with -DMODULUS_NO_STATS removes them: the sieves then never take the counting path, nor does the thread pool count lock waits.
+#ifdef MODULUS_NO_STATS
+constexpr bool stats_compiled = false;
+#else
+constexpr bool stats_compiled = true;
+#endif
+
+// The counters of one partition of a degree, or their sum over the partitions.
+struct PartitionCounters
+{
+    uint64_t products    = 0;  // products computed
+    uint64_t eliminated  = 0;  // products which marked a candidate as reducible first
+    uint64_t redundant   = 0;  // products of a candidate which was marked before
+    uint64_t nanoseconds = 0;  // time of the tasks, summed over the threads
+
+    PartitionCounters & operator +=(PartitionCounters const & c)
+    {
+        products    += c.products;
+        eliminated  += c.eliminated;
+        redundant   += c.redundant;
+        nanoseconds += c.nanoseconds;
+        return *this;
+    }
+};
+
+// The counters of a sieve over the degrees 0 ... n-1, one slot per thread, degree and partition of decomp(k).
+// A task adds its counts to the slot of its thread once at its end, so the threads never share a slot.
+// The slots are merged when the report is written.
+class SieveCounters
+{
+public:
+    SieveCounters(unsigned n, unsigned threads)
+        : partitions(n), candidates(n, 0), slots(threads, vector<vector<PartitionCounters>>(n))
+    {
+        for (unsigned k = 0; k < n; ++k)
+        {
+            partitions[k] = decomp(k);
+            for (auto & slot : slots) slot[k].resize(partitions[k].size());
+        }
+    }
+
+    unsigned degrees() const { return static_cast<unsigned>(partitions.size()); }
+
+    // The slot of partition i of degree k for the thread with the given index in the pool.
+    PartitionCounters & local(size_t thread, unsigned k, size_t i) { return slots[thread][k][i]; }
+
+    // The number of candidates of degree k, set by the sieve.
+    void set_candidates(unsigned k, uint64_t c) { candidates[k] = c; }
+
+    // Contended locks of the thread pool during the sieve and the wall time.
+    uint64_t lock_waits = 0;
+    double   wall       = 0.0;
+
+    // The counters of partition i of degree k, summed over the threads.
+    PartitionCounters merged(unsigned k, size_t i) const
+    {
+        PartitionCounters c;
+        for (auto const & slot : slots) c += slot[k][i];
+        return c;
+    }
+
+    PartitionCounters merged(unsigned k) const
+    {
+        PartitionCounters c;
+        for (size_t i = 0; i < partitions[k].size(); ++i) c += merged(k, i);
+        return c;
+    }
+
+    // Prints every degree and its most expensive partitions in time.
+    void print(std::ostream & out, size_t top = 3) const
+    {
+        out << "Sieve counters with " << slots.size() << " thread(s) in " << wall << " s, " << lock_waits << " lock wait(s):" << std::endl;
+        for (unsigned k = 0; k < degrees(); ++k)
+        {
+            auto const c = merged(k);
+            out << "  degree " << k << ": " << candidates[k] << " candidates, " << partitions[k].size() << " partitions, "
+                << c.products << " products, " << c.eliminated << " eliminated, " << c.redundant << " redundant, ";
+            out << c.nanoseconds * 1e-9 << " s" << std::endl;
+
+            vector<size_t> order(partitions[k].size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            vector<PartitionCounters> parts(order.size());
+            for (size_t i = 0; i < order.size(); ++i) parts[i] = merged(k, i);
+            std::sort(order.begin(), order.end(), [&parts](size_t a, size_t b) { return parts[a].nanoseconds > parts[b].nanoseconds; });
+            for (size_t j = 0; j < std::min(top, order.size()); ++j)
+            {
+                auto const & pc = parts[order[j]];
+                if (pc.products == 0) break;
+                out << "    partition [";
+                write_partition(out, partitions[k][order[j]]);
+                out << "]: " << pc.products << " products, " << pc.eliminated << " eliminated, " << pc.redundant << " redundant, "
+                    << pc.nanoseconds * 1e-9 << " s" << std::endl;
+            }
+        }
+    }
+
+    void write_json(std::ostream & out) const
+    {
+        out << "{\"threads\": " << slots.size() << ", \"wall\": " << wall << ", \"lock_waits\": " << lock_waits << ", \"degrees\": [";
+        for (unsigned k = 0; k < degrees(); ++k)
+        {
+            out << (k == 0 ? "\n" : ",\n") << "  {\"degree\": " << k << ", \"candidates\": " << candidates[k]
+                << ", ";
+            write_json(out, merged(k));
+            out << ", \"partitions\": [";
+            for (size_t i = 0; i < partitions[k].size(); ++i)
+            {
+                out << (i == 0 ? "" : ", ") << "{\"parts\": [";
+                write_partition(out, partitions[k][i]);
+                out << "], ";
+                write_json(out, merged(k, i));
+                out << "}";
+            }
+            out << "]}";
+        }
+        out << "\n]}" << std::endl;
+    }
+
+private:
+    vector<vector<vector<unsigned>>>          partitions;  // partitions[k] = decomp(k)
+    vector<uint64_t>                          candidates;
+    vector<vector<vector<PartitionCounters>>> slots;       // slots[thread][k][i]
+
+    static void write_partition(std::ostream & out, vector<unsigned> const & dc)
+    {
+        for (size_t j = 0; j < dc.size(); ++j) out << (j == 0 ? "" : ", ") << dc[j];
+    }
+
+    static void write_json(std::ostream & out, PartitionCounters const & c)
+    {
+        out << "\"products\": " << c.products << ", \"eliminated\": " << c.eliminated << ", \"redundant\": " << c.redundant
+            << ", \"seconds\": " << c.nanoseconds * 1e-9;
+    }
+};
+
+} // namespace Modulus
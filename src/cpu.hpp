@@ -0,0 +1,61 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no cpu.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// Runtime detection of optional instruction set extensions.
+// Kernels compiled with __attribute__((target(...))) must only be called if the corresponding function returns true.
+// MODULUS_X86_TARGETS is defined iff such target specific kernels can be compiled at all.
+// 32 bit x86 is left out, as the kernels move 64 bit words to SSE registers by _mm_cvtsi64_si128.
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define MODULUS_X86_TARGETS 1
+#endif
+
+namespace Modulus { namespace Utility
+{
+
+inline bool cpu_has_pclmul() noexcept
+{
+#if defined(__PCLMUL__)
+    return true;
+#elif defined(MODULUS_X86_TARGETS)
+    static bool const has = (__builtin_cpu_init(), __builtin_cpu_supports("pclmul"));
+    return has;
+#else
+    return false;
+#endif
+}
+
+inline bool cpu_has_avx2() noexcept
+{
+#if defined(__AVX2__)
+    return true;
+#elif defined(MODULUS_X86_TARGETS)
+    static bool const has = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return has;
+#else
+    return false;
+#endif
+}
+
+}} // namespace Modulus::Utility
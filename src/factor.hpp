@@ -0,0 +1,262 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <random>
+#include <algorithm>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "irreducibility.hpp"
+#include "linalg.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+using std::pair;
+
+// Factorization of polynomials of (Z/pZ)[x] into irreducible factors.
+// The factorization is computed in three stages:
+//  1. square-free factorization, separating factors of different multiplicity,
+//  2. distinct-degree factorization, separating irreducible factors of different degree,
+//  3. equal-degree factorization, splitting products of irreducible factors of the same degree.
+// Stage 3 uses Berlekamp's Q-matrix for small p and the probabilistic Cantor-Zassenhaus algorithm otherwise.
+
+// For p up to this, equal-degree factorization uses Berlekamp's algorithm.
+constexpr unsigned berlekamp_max_p = 32;
+
+template <unsigned p>
+struct Factorization
+{
+    Z<p>                     unit;     // the leading coefficient of the factored polynomial
+    vector<Polynomial<Z<p>>> factors;  // monic irreducible factors with repetition, ascending in degree
+};
+
+// Formal derivative of f.
+template <unsigned p>
+Polynomial<Z<p>> derivative(Polynomial<Z<p>> const & f)
+{
+    if (deg(f) == 0) return Polynomial<Z<p>>();
+    vector<Z<p>> coeffs(deg(f));
+    for (size_t i = 1; i <= deg(f); ++i) coeffs[i - 1] = Z<p>(static_cast<unsigned>(i % Z<p>::modulus())) * f.at(i);
+    return Polynomial<Z<p>>::fromCoeffVector(coeffs);
+}
+
+// For f = g^p returns g. f must only have monomials whose exponents are multiples of p.
+// This holds as the Frobenius map is the identity on Z/pZ, so g^p(x) = g(x^p).
+template <unsigned p>
+Polynomial<Z<p>> pth_root(Polynomial<Z<p>> const & f)
+{
+    vector<Z<p>> coeffs(deg(f) / Z<p>::modulus() + 1);
+    for (size_t i = 0; i < coeffs.size(); ++i) coeffs[i] = f.at(i * Z<p>::modulus());
+    return Polynomial<Z<p>>::fromCoeffVector(coeffs);
+}
+
+// Square-free factorization of monic f.
+// Returns pairs (g, m) with square-free, pairwise coprime g, such that f is the product of all g^m.
+template <unsigned p>
+vector<pair<Polynomial<Z<p>>, unsigned>> square_free_factorization(Polynomial<Z<p>> const & f)
+{
+    using KPoly = Polynomial<Z<p>>;
+    vector<pair<KPoly, unsigned>> res;
+    if (deg(f) == 0) return res;
+
+    KPoly const df = derivative(f);
+    KPoly c;
+    if (df.is_zero()) c = f;
+    else
+    {
+        c = gcd(f, df);
+        KPoly w = f / c;
+        for (unsigned i = 1; deg(w) > 0; ++i)
+        {
+            KPoly const y   = gcd(w, c);
+            KPoly const fac = w / y;
+            if (deg(fac) > 0) res.emplace_back(fac, i);
+            w  = y;
+            c /= y;
+        }
+    }
+
+    // What remains is a p-th power.
+    if (deg(c) > 0)
+        for (auto & gm : square_free_factorization(pth_root(c)))
+            res.emplace_back(std::move(gm.first), gm.second * Z<p>::modulus());
+    return res;
+}
+
+// Distinct-degree factorization of square-free monic f.
+// Returns pairs (g, d) such that g is the product of all irreducible factors of f of degree d.
+template <unsigned p>
+vector<pair<Polynomial<Z<p>>, unsigned>> distinct_degree_factorization(Polynomial<Z<p>> f)
+{
+    using KPoly = Polynomial<Z<p>>;
+    vector<pair<KPoly, unsigned>> res;
+
+    KPoly const x(Z<p>(1), 1);
+    KPoly       h = x % f; // h is x^(p^d) mod f.
+    Reducer<p>  red(f);
+    for (unsigned d = 1; deg(f) >= 2 * d; ++d)
+    {
+        h = red.powmod(h, Z<p>::modulus());
+        KPoly const g = gcd(h - x, f);
+        if (deg(g) == 0) continue;
+        res.emplace_back(g, d);
+        f /= g;
+        h %= f;
+        red = Reducer<p>(f);
+    }
+    if (deg(f) > 0) res.emplace_back(f, deg(f));
+    return res;
+}
+
+// Berlekamp's algorithm: splits square-free monic f into its irreducible factors.
+// The polynomials g with g^p = g mod f form a vector space (the Berlekamp subalgebra) whose dimension is the number of factors.
+// As g^p = g(x^p), it is the left null space of Q - I, where the rows of Q are x^(ip) mod f.
+// For any such g, f is the product of all gcd(f, g - s), s in Z/pZ.
+template <unsigned p>
+vector<Polynomial<Z<p>>> berlekamp(Polynomial<Z<p>> const & f)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+    size_t const n = deg(f);
+
+    // Build (Q - I) transposed, so that its null space is the Berlekamp subalgebra.
+    vector<vector<K>> qt(n, vector<K>(n));
+    Reducer<p> const red(f);
+    KPoly const      xp = red.powmod(KPoly(K(1), 1), K::modulus());
+    KPoly            row(K(1));
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j) qt[j][i] = row.at(j);
+        qt[i][i] -= K(1);
+        row = red.mulmod(row, xp);
+    }
+    auto const basis = null_space(std::move(qt));
+
+    vector<KPoly> factors = { f };
+    for (auto const & v : basis)
+    {
+        if (factors.size() == basis.size()) break;
+        KPoly const g = KPoly::fromCoeffVector(v);
+        if (deg(g) == 0) continue;
+
+        vector<KPoly> refined;
+        for (auto const & h : factors)
+        {
+            if (deg(h) <= 1) { refined.push_back(h);  continue; }
+            KPoly rest = h;
+            for (unsigned s = 0; s < K::modulus() and deg(rest) > 0; ++s)
+            {
+                KPoly const d = gcd(g - K(s), rest);
+                if (deg(d) == 0) continue;
+                refined.push_back(d);
+                rest /= d;
+            }
+        }
+        factors = std::move(refined);
+    }
+    return factors;
+}
+
+// Cantor-Zassenhaus equal-degree factorization: splits square-free monic f, whose irreducible factors all have degree d.
+// For odd p a random a gives gcd(a^((p^d - 1)/2) - 1, f), for p = 2 the trace a + a^2 + ... + a^(2^(d-1)) is used instead.
+template <unsigned p>
+vector<Polynomial<Z<p>>> cantor_zassenhaus(Polynomial<Z<p>> const & f, unsigned d, std::mt19937_64 & rng)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+    unsigned const q = K::modulus();
+    if (deg(f) <= d) return { f };
+
+    Reducer<p> const red(f);
+    KPoly g;
+    do
+    {
+        vector<K> coeffs(deg(f));
+        for (auto & c : coeffs) c = K(static_cast<unsigned>(rng() % q));
+        KPoly const a = KPoly::fromCoeffVector(coeffs);
+        if (deg(a) == 0) continue;
+
+        KPoly b;
+        if (q == 2)
+        {
+            KPoly t = a;
+            b = a;
+            for (unsigned j = 1; j < d; ++j) { t = red.mulmod(t, t);  b += t; }
+        }
+        else
+        {
+            // (q^d - 1)/2 = (q - 1)/2 * (1 + p + ... + p^(d-1)), so b is the product of c^(p^j) with c = a^((p-1)/2).
+            KPoly t = red.powmod(a, (q - 1) / 2);
+            b = t;
+            for (unsigned j = 1; j < d; ++j) { t = red.powmod(t, q);  b = red.mulmod(b, t); }
+            b -= KPoly(K(1));
+        }
+        g = gcd(b, f);
+    }
+    while (deg(g) == 0 or deg(g) == deg(f));
+
+    auto res  = cantor_zassenhaus(g,     d, rng);
+    auto rest = cantor_zassenhaus(f / g, d, rng);
+    res.insert(res.end(), rest.begin(), rest.end());
+    return res;
+}
+
+// Sorts factors ascending in degree, factors of the same degree by their coefficients.
+template <unsigned p>
+void sort_factors(vector<Polynomial<Z<p>>> & factors)
+{
+    using KPoly = Polynomial<Z<p>>;
+    std::sort(factors.begin(), factors.end(),
+              [](KPoly const & g, KPoly const & h) { return deg(g) < deg(h) or (deg(g) == deg(h) and g < h); });
+}
+
+// Factors f into its leading coefficient and monic irreducible factors.
+template <unsigned p>
+Factorization<p> factor(Polynomial<Z<p>> const & f)
+{
+    using KPoly = Polynomial<Z<p>>;
+    Factorization<p> res { f.leading_coeff(), { } };
+    if (deg(f) == 0) return res;
+
+    std::mt19937_64 rng(deg(f));
+    for (auto const & sf : square_free_factorization(monic(f)))
+    for (auto const & dd : distinct_degree_factorization(sf.first))
+    {
+        vector<KPoly> irr;
+        if      (deg(dd.first) == dd.second) irr = { dd.first };
+        else if (Z<p>::modulus() <= berlekamp_max_p)       irr = berlekamp(dd.first);
+        else                                 irr = cantor_zassenhaus(dd.first, dd.second, rng);
+
+        for (auto & g : irr)
+            for (unsigned m = 0; m < sf.second; ++m) res.factors.push_back(g);
+    }
+
+    sort_factors(res.factors);
+    return res;
+}
+
+} // namespace Modulus
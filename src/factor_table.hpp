@@ -0,0 +1,133 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "irreducibility.hpp"
+#include "factor.hpp"
+#include "parallel.hpp"
+#include "rank_sieve.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+using std::uint64_t;
+
+// Table of the smallest irreducible factor of every monic polynomial of (Z/pZ)[x] with degree < n, like the smallest prime factor sieve of integers.
+// The irreducible polynomials of degree <= (n-1)/2 are numbered ascending in degree, then in rank.
+// For every degree k the table holds p^k entries, indexed by rank: 0 for irreducible polynomials, else 1 + the number of the smallest factor.
+// That is 4 bytes per polynomial, instead of the map of factor vectors of getPolynomialsDecomposition.
+// Complete factorizations are rebuilt on demand by exact division through the smallest factor.
+template <unsigned p>
+class FactorTable
+{
+public:
+    using K          = Z<p>;
+    using KPoly      = Polynomial<K>;
+    using index_type = std::uint32_t;
+
+    // Builds the table of the degrees < n on the thread pool.
+    explicit FactorTable(unsigned n) : n(n), table(n)
+    {
+        unsigned const half = n > 0 ? (n - 1) / 2 : 0;
+        RankSieve<p> sieve(half + 1);
+        sieve.run();
+        for (unsigned d = 1; d <= half; ++d)
+            for (auto & g : sieve.irreducibles(d)) factors.push_back(std::move(g));
+
+        uint64_t size = 1;
+        for (unsigned k = 0; k < n; ++k, size *= K::modulus()) table[k].assign(size, 0);
+
+        // Every irreducible g of degree d marks all g * h with monic h of degree k - d >= d.
+        // Tasks of different g may write the same entry, the smallest number wins.
+        auto & pool = Utility::thread_pool();
+        Utility::ThreadPool::TaskGroup group;
+        uint64_t const grain = 4096;
+        for (unsigned k = 2; k < n; ++k)
+        for (index_type i = 0; i < factors.size() and 2 * deg(factors[i]) <= k; ++i)
+        {
+            unsigned const hdeg = k - deg(factors[i]);
+            uint64_t       hcount = 1;
+            for (unsigned j = 0; j < hdeg; ++j) hcount *= K::modulus();
+            for (uint64_t r = 0; r < hcount; r += grain)
+                pool.spawn(group, [this, k, i, hdeg, r, end = std::min(hcount, r + grain)]
+                {
+                    for (uint64_t s = r; s < end; ++s)
+                        store_min(table[k][rank<p>(factors[i] * unrank<p>(s, hdeg))], i + 1);
+                });
+        }
+        pool.wait(group);
+    }
+
+    unsigned degrees() const { return n; }
+
+    // Bytes used by the table entries.
+    uint64_t bytes() const
+    {
+        uint64_t b = 0;
+        for (auto const & t : table) b += t.size() * sizeof(index_type);
+        return b;
+    }
+
+    // Whether f is irreducible. deg(f) must be < degrees().
+    bool is_irreducible(KPoly const & f) const
+    {
+        return deg(f) > 0 and table[deg(f)][rank<p>(monic(f))] == 0;
+    }
+
+    // Factors f into its leading coefficient and monic irreducible factors, like factor(f). deg(f) must be < degrees().
+    Factorization<p> factor(KPoly const & f) const
+    {
+        Factorization<p> res { f.leading_coeff(), { } };
+        if (deg(f) == 0) return res;
+
+        KPoly g = monic(f);
+        while (deg(g) > 0)
+        {
+            index_type const i = table[deg(g)][rank<p>(g)];
+            if (i == 0) { res.factors.push_back(g);  break; }
+            res.factors.push_back(factors[i - 1]);
+            g /= factors[i - 1];
+        }
+        sort_factors(res.factors);
+        return res;
+    }
+
+private:
+    unsigned                   n;
+    vector<KPoly>              factors;  // the irreducible polynomials of degree 1 ... (n-1)/2, numbered from 1
+    vector<vector<index_type>> table;
+
+    static void store_min(index_type & entry, index_type i)
+    {
+        index_type cur = __atomic_load_n(&entry, __ATOMIC_RELAXED);
+        while ((cur == 0 or i < cur) and
+               not __atomic_compare_exchange_n(&entry, &cur, i, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) { }
+    }
+};
+
+} // namespace Modulus
@@ -37,19 +37,80 @@ const string HELP_TEXT =
     "Example usage: -o \"irrPoly.txt\"                                                                          \n"
     "This option does not restrict usage with other options.                                                    \n"
     "                                                                                                           \n"
-    //~ " (2a) --input                                                                                              \n"
-    //~ " (2b) -i                                                                                                   \n"
-    //~ "Specify a file to read from:                                                                               \n"
-    //~ "parameters: filename                                                                                       \n"
-    //~ "filename denotes some valid file name                                                                      \n"
-    //~ " If no file is specified, all input will be read from the console.                                         \n"
-    //~ "Example usage: -i \"irrPoly.txt\"                                                                          \n"
-    //~ "This option does not restrict usage with other options, but may be ignored.                                \n"
-    //~ "                                                                                                           \n"
+    " (2a) --input                                                                                              \n"
+    " (2b) -i                                                                                                   \n"
+    "Specify a file to read further polynomials of -t from:                                                     \n"
+    "parameters: filename                                                                                       \n"
+    "filename denotes some valid file name, - denotes the standard input.                                       \n"
+    " The file holds one polynomial per line in the format of the polylist of -t, blanks are allowed            \n"
+    " around + and -, so the polynomials listed by -l (without the headers) may be read back.                   \n"
+    " They are tested after the ones given on the command line, in batches, so the file may be of any size.     \n"
+    "Example usage: -i \"polys.txt\" -t 2                                                                       \n"
+    "This option only affects -t.                                                                               \n"
+    "                                                                                                           \n"
+    " (3a) --exact                                                                                              \n"
+    " (3b) -e                                                                                                   \n"
+    "List only the irreducible polynomials of exactly the given degrees instead of all degrees up to them.      \n"
+    " They are generated directly as minimal polynomials in GF(p^d), without any polynomial of lower degree.    \n"
+    "Example usage: -e -l 12 2                                                                                  \n"
+    "This option only affects -l.                                                                               \n"
+    "                                                                                                           \n"
+    " (4)  --threads                                                                                            \n"
+    "Specify the number of threads used by the parallel algorithms:                                             \n"
+    "parameters: N                                                                                              \n"
+    "N is a non-negative integer, 0 means one thread per hardware thread (default).                             \n"
+    "Example usage: --threads 8                                                                                 \n"
+    "This option does not restrict usage with other options.                                                    \n"
+    "                                                                                                           \n"
+    " (5a) --verbose                                                                                            \n"
+    " (5b) -v                                                                                                   \n"
+    "Print statistics like the throughput of the sieve per degree or of -t in polynomials/s on the error stream.\n"
+    "This option does not restrict usage with other options.                                                    \n"
+    "                                                                                                           \n"
+    " (6)  --memory-limit                                                                                       \n"
+    "Bound the memory of the sieve of -l:                                                                       \n"
+    "parameters: MiB                                                                                            \n"
+    "MiB is a non-negative integer, 0 means unlimited (default).                                                \n"
+    " If the sieve would need more, it processes every degree in windows of ranks that fit into the limit.      \n"
+    " This takes more time, but the polynomials are listed in the same order.                                   \n"
+    "Example usage: --memory-limit 64 -l 30 2                                                                   \n"
+    "This option only affects -l.                                                                               \n"
+    "                                                                                                           \n"
+    " (7)  --cache                                                                                              \n"
+    "Keep the irreducible polynomials of every (p, degree) in a directory and reuse them in later runs:         \n"
+    "parameters: dir                                                                                            \n"
+    "dir denotes some directory, it is created if missing.                                                      \n"
+    " Cached degrees are memory-mapped instead of sieved, missing degrees are sieved and added.                 \n"
+    " Corrupt or outdated files are detected by a version and a checksum and recomputed.                        \n"
+    "Example usage: --cache \"irrCache\" -l 24 2                                                                \n"
+    "This option affects -l without -e and -t.                                                                  \n"
+    "                                                                                                           \n"
+    " (8)  --format                                                                                             \n"
+    "Specify the format of the polynomials listed by -l:                                                        \n"
+    "parameters: format                                                                                         \n"
+    "format is one of                                                                                           \n"
+    "   text     (default) a header per degree and one polynomial per line                                      \n"
+    "   csv      one line p,degree,rank,polynomial per polynomial                                               \n"
+    "   json     one object with an array of polynomials per degree                                             \n"
+    "   binary   the ranks of the polynomials as 64 bit words, see output.hpp                                   \n"
+    " The rank of x^d + c[d-1]x^(d-1) + ... + c[0] is the p-adic number c[d-1] ... c[0].                        \n"
+    "Example usage: --format csv -o \"irrPoly.csv\" -l 10 2                                                     \n"
+    "This option only affects -l.                                                                               \n"
+    "                                                                                                           \n"
+    " (9a) --stats                                                                                              \n"
+    " (9b) --stats-json                                                                                         \n"
+    "Count the work of the sieve per degree and partition and print it on the error stream:                     \n"
+    "parameters: none for --stats, file for --stats-json                                                        \n"
+    "file denotes some valid file name the counters are written to as JSON instead.                             \n"
+    " Counted are the candidates, products, eliminations, redundant eliminations, the waits for the locks       \n"
+    " of the thread pool and the time of every partition. Compiled with MODULUS_NO_STATS, the option fails.     \n"
+    "Example usage: --stats-json \"stats.json\" -l 20 2                                                         \n"
+    "This option affects -l without -e and --memory-limit.                                                      \n"
+    "                                                                                                           \n"
     " OPTIONS LISTED ABOVE MUST BE SET BEFORE THE FOLLOWING                                                     \n"
     "                                                                                                           \n"
-    " (5a) -l                                                                                                   \n"
-    " (5b) --list                                                                                               \n"
+    " (10a) -l                                                                                                  \n"
+    " (10b) --list                                                                                              \n"
     "List irreducible polynomials:                                                                              \n"
     "parameters: ds [ps=2-20]                                                                                   \n"
     "ds is the list of degrees,                                                                                 \n"
@@ -57,7 +118,7 @@ const string HELP_TEXT =
     " It must have one of these formats:                                                                        \n"
     "   d1,d2,d3 (explicit list)                                                                                \n"
     "   d        (one for all)                                                                                  \n"
-    "ps is the optional list of primes < 20 (others ignored).                                                   \n"
+    "ps is the optional list of primes < 2^31 (others ignored), by default the primes < 20.                     \n"
     " It must have one of these formats:                                                                        \n"
     "   p1,p2,p3 (explicit list)                                                                                \n"
     "   p-q      (explicit range)                                                                               \n"
@@ -70,15 +131,16 @@ const string HELP_TEXT =
     "Example usage: --list  3  11-17                                                                            \n"
     " Lists all irr. Polynomials of (Z/11Z)[x], (Z/13Z)[x] and (Z/17Z)[x] whose degree is <= 3.                 \n"
     "                                                                                                           \n"
-    " (5c) -t                                                                                                   \n"
-    " (5d) -test                                                                                                \n"
+    " (10c) -t                                                                                                  \n"
+    " (10d) -test                                                                                               \n"
     "Test the given polynomials if they are irreducible.                                                        \n"
     "parameters: p, polylist                                                                                    \n"
-    "p must be a prime number and < 20.                                                                         \n"
+    "p must be a prime number and < 2^31.                                                                       \n"
     "polylist is a list of any polynomials of (Z/pZ)[x], separated with spaces.                                 \n"
     " Every monomial must have the format ax^d, x^d, ax or a, where a is of 0 ... p-1, d some natural number.   \n"
     "  For p = 2, the only format allowed is x^d and explicitly x and 1.                                        \n"
     " Every polynomial then is a concatination of these monomials with + or - between.                          \n"
+    " Degrees must be < 2^24.                                                                                   \n"
     " You will be asked wether the interpretation of the polynomial is correct.                                 \n"
     "If the polynomial is reduclible, there will be given a decomposition,                                      \n"
     "else it will be labeled as irreducible.                                                                    \n"
@@ -0,0 +1,114 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "reduction.hpp"
+
+namespace Modulus
+{
+
+// Returns f divided by its leading coefficient. The zero polynomial stays zero.
+template <typename T, typename deg_type>
+Polynomial<T, deg_type> monic(Polynomial<T, deg_type> const & f)
+{
+    if (f.is_zero() or f.leading_coeff() == T(1)) return f;
+    return f * (T(1) / f.leading_coeff());
+}
+
+// The greatest common divisor of a and b, normalized to be monic.
+// gcd(0, 0) is 0.
+template <typename T, typename deg_type>
+Polynomial<T, deg_type> gcd(Polynomial<T, deg_type> a, Polynomial<T, deg_type> b)
+{
+    while (not b.is_zero())
+    {
+        a %= b;
+        std::swap(a, b);
+    }
+    return monic(a);
+}
+
+// Calculates base^e mod f by square and multiply.
+template <typename T, typename deg_type>
+Polynomial<T, deg_type> powmod(Polynomial<T, deg_type> base, std::uint64_t e, Polynomial<T, deg_type> const & f)
+{
+    Polynomial<T, deg_type> result(T(1));
+    base %= f;
+    for (; e != 0; e >>= 1)
+    {
+        if (e & 1u) result = result * base % f;
+        if (e > 1)  base   = base   * base % f;
+    }
+    return result % f;
+}
+
+// The distinct prime divisors of n in ascending order.
+inline std::vector<unsigned> prime_divisors(unsigned n)
+{
+    std::vector<unsigned> res;
+    for (unsigned q = 2; q * q <= n; ++q)
+    {
+        if (n % q != 0) continue;
+        res.push_back(q);
+        while (n % q == 0) n /= q;
+    }
+    if (n > 1) res.push_back(n);
+    return res;
+}
+
+// Rabin's irreducibility test.
+// f of degree n > 0 is irreducible iff x^(p^n) = x mod f and gcd(x^(p^(n/q)) - x, f) = 1 for every prime divisor q of n.
+// The powers x^(p^i) mod f are calculated by repeatedly raising to the p-th power, so the test needs
+// O(n log p) multiplications modulo f instead of any table of lower degree polynomials.
+// Constant polynomials are units or zero and therefore not irreducible.
+template <unsigned p, typename deg_type>
+bool is_irreducible(Polynomial<Z<p>, deg_type> const & g)
+{
+    using KPoly = Polynomial<Z<p>, deg_type>;
+
+    if (deg(g) == 0) return false;
+    if (deg(g) == 1) return true;
+
+    KPoly const f = monic(g);
+    unsigned const n = deg(f);
+    KPoly const x = KPoly(Z<p>(1), 1) % f;
+    Reducer<p, deg_type> const red(f);
+
+    std::vector<unsigned> const qs = prime_divisors(n);
+
+    // x_pow is x^(p^i) mod f.
+    KPoly x_pow = x;
+    for (unsigned i = 1; i <= n; ++i)
+    {
+        x_pow = red.powmod(x_pow, Z<p>::modulus());
+        if (i == n) break;
+        for (unsigned q : qs)
+            if (i == n / q and deg(gcd(x_pow - x, f)) != 0) return false;
+    }
+    return x_pow == x;
+}
+
+} // namespace Modulus
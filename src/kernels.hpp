@@ -0,0 +1,134 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no kernels.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// Multiply-accumulate kernels for byte coefficients with lazy reduction.
+// The products of the coefficients are summed up in 16-bit accumulators without any reduction modulo p;
+// the caller reduces the accumulators before they may overflow, i. e. after at most lazy_rows<p>() rows.
+// So the kernels do not depend on p and vectorize to plain 16-bit multiplications and additions.
+
+#include <cstdint>
+#include <cstddef>
+
+#include "cpu.hpp"
+
+#ifdef MODULUS_X86_TARGETS
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Modulus { namespace Utility
+{
+
+// The number of rows t * b[j] with t, b[j] < p which fit into a 16-bit accumulator that holds a value < p.
+// It is 0 if a single row may overflow already, i. e. for p > 181; the kernels must not be used then.
+template <unsigned p>
+constexpr std::size_t lazy_rows() noexcept
+{
+    return p < 2 or p > 181 ? 0 : (0xFFFFu - (p - 1)) / ((p - 1) * (p - 1));
+}
+
+// acc[0 .. n) += t * b[0 .. n) without reduction.
+inline void mul_add_row_portable(std::uint16_t * acc, std::uint8_t const * b, std::size_t n, std::uint16_t t) noexcept
+{
+    for (std::size_t j = 0; j < n; ++j) acc[j] = static_cast<std::uint16_t>(acc[j] + t * b[j]);
+}
+
+#ifdef MODULUS_X86_TARGETS
+// Same as mul_add_row_portable with 8 lanes of SSE2.
+__attribute__((target("sse2")))
+inline void mul_add_row_sse2(std::uint16_t * acc, std::uint8_t const * b, std::size_t n, std::uint16_t t) noexcept
+{
+    __m128i const tt   = _mm_set1_epi16(static_cast<short>(t)),
+                  zero = _mm_setzero_si128();
+    std::size_t j = 0;
+    for (; j + 8 <= n; j += 8)
+    {
+        __m128i const bj = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(b + j)), zero);
+        __m128i       a  = _mm_loadu_si128(reinterpret_cast<__m128i const *>(acc + j));
+        a = _mm_add_epi16(a, _mm_mullo_epi16(bj, tt));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + j), a);
+    }
+    mul_add_row_portable(acc + j, b + j, n - j, t);
+}
+
+// Same as mul_add_row_portable with 16 lanes of AVX2. Only call if cpu_has_avx2().
+__attribute__((target("avx2")))
+inline void mul_add_row_avx2(std::uint16_t * acc, std::uint8_t const * b, std::size_t n, std::uint16_t t) noexcept
+{
+    __m256i const tt = _mm256_set1_epi16(static_cast<short>(t));
+    std::size_t j = 0;
+    for (; j + 16 <= n; j += 16)
+    {
+        __m256i const bj = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<__m128i const *>(b + j)));
+        __m256i       a  = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(acc + j));
+        a = _mm256_add_epi16(a, _mm256_mullo_epi16(bj, tt));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + j), a);
+    }
+    mul_add_row_sse2(acc + j, b + j, n - j, t);
+}
+
+// acc[i + j] += a[i] * b[j] for all i < na, j < nb without reduction; rows with a[i] == 0 are skipped.
+__attribute__((target("avx2")))
+inline void mul_add_avx2(std::uint16_t * acc, std::uint8_t const * a, std::size_t na, std::uint8_t const * b, std::size_t nb) noexcept
+{
+    for (std::size_t i = 0; i < na; ++i) if (a[i] != 0) mul_add_row_avx2(acc + i, b, nb, a[i]);
+}
+
+__attribute__((target("sse2")))
+inline void mul_add_sse2(std::uint16_t * acc, std::uint8_t const * a, std::size_t na, std::uint8_t const * b, std::size_t nb) noexcept
+{
+    for (std::size_t i = 0; i < na; ++i) if (a[i] != 0) mul_add_row_sse2(acc + i, b, nb, a[i]);
+}
+#endif
+
+inline void mul_add_portable(std::uint16_t * acc, std::uint8_t const * a, std::size_t na, std::uint8_t const * b, std::size_t nb) noexcept
+{
+    for (std::size_t i = 0; i < na; ++i) if (a[i] != 0) mul_add_row_portable(acc + i, b, nb, a[i]);
+}
+
+// acc[0 .. n) += t * b[0 .. n) without reduction, using the widest lanes the CPU has.
+inline void mul_add_row(std::uint16_t * acc, std::uint8_t const * b, std::size_t n, std::uint16_t t) noexcept
+{
+#ifdef MODULUS_X86_TARGETS
+    if (n >= 16 and cpu_has_avx2()) { mul_add_row_avx2(acc, b, n, t);  return; }
+#if defined(__SSE2__)
+    mul_add_row_sse2(acc, b, n, t);  return;
+#endif
+#endif
+    mul_add_row_portable(acc, b, n, t);
+}
+
+// acc[i + j] += a[i] * b[j] for all i < na, j < nb without reduction, using the widest lanes the CPU has.
+inline void mul_add(std::uint16_t * acc, std::uint8_t const * a, std::size_t na, std::uint8_t const * b, std::size_t nb) noexcept
+{
+#ifdef MODULUS_X86_TARGETS
+    if (nb >= 16 and cpu_has_avx2()) { mul_add_avx2(acc, a, na, b, nb);  return; }
+#if defined(__SSE2__)
+    mul_add_sse2(acc, a, na, b, nb);  return;
+#endif
+#endif
+    mul_add_portable(acc, a, na, b, nb);
+}
+
+}} // namespace Modulus::Utility
@@ -0,0 +1,80 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no linalg.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ * 
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <vector>
+#include <utility>
+
+#include "Z.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+
+// Returns a basis of the null space of the matrix m over Z/pZ, i. e. of all vectors v with m v = 0.
+// m is given as vector of rows, all of the same length.
+template <unsigned p>
+vector<vector<Z<p>>> null_space(vector<vector<Z<p>>> m)
+{
+    using K = Z<p>;
+    size_t const rows = m.size(),
+                 cols = m.empty() ? 0 : m.front().size();
+    vector<size_t> pivot_col_of_row;
+    vector<bool>   is_pivot(cols, false);
+
+    // Gauss-Jordan elimination to the reduced row echelon form.
+    size_t row = 0;
+    for (size_t col = 0; col < cols and row < rows; ++col)
+    {
+        size_t r = row;
+        while (r < rows and m[r][col] == K()) ++r;
+        if (r == rows) continue;
+        std::swap(m[r], m[row]);
+        K const inv_lead = K(1) / m[row][col];
+        for (auto & z : m[row]) z *= inv_lead;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            if (i == row or m[i][col] == K()) continue;
+            K const c = m[i][col];
+            for (size_t j = col; j < cols; ++j) m[i][j] -= c * m[row][j];
+        }
+        pivot_col_of_row.push_back(col);
+        is_pivot[col] = true;
+        ++row;
+    }
+
+    // Every free column gives one basis vector.
+    vector<vector<K>> basis;
+    for (size_t free = 0; free < cols; ++free)
+    {
+        if (is_pivot[free]) continue;
+        vector<K> v(cols);
+        v[free] = K(1);
+        for (size_t r = 0; r < pivot_col_of_row.size(); ++r) v[pivot_col_of_row[r]] = -m[r][free];
+        basis.push_back(std::move(v));
+    }
+    return basis;
+}
+
+} // namespace Modulus
@@ -23,6 +23,7 @@
 #include "Polynomial.hpp"
 #include "container.hpp"
 #include "sieve.hpp"
+#include "options.hpp"
 #include "helptext.hpp"
 
 
@@ -34,6 +35,11 @@
 #include <map>
 
 #include <algorithm>
+#include <limits>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 
 using std::cout;
 using std::cin;
@@ -51,7 +57,8 @@ using std::map;
 using namespace Modulus;
 
 int main2(int argc, char ** argv);
-int main3(int argc, char ** argv, std::ostream & out);
+bool parse_unsigned(char const * arg, unsigned long max, unsigned & res);
+int main3(int argc, char ** argv, std::ostream & out, Options const & opts);
 
 int main (int argc, char ** argv)
 {
@@ -72,23 +79,109 @@ int main (int argc, char ** argv)
 
 int main2(int argc, char ** argv)
 {
-    if (string("-o")       == *argv or
-        string("--output") == *argv)
+    // More threads than this only slow down, a typo like -1 must not start billions of them.
+    unsigned const max_threads = 1024;
+
+    Options  opts;
+    ofstream file;
+    std::ostream * out = &cout;
+
+    for (; *argv != nullptr; ++argv)
     {
-        if (*++argv == nullptr) ERROR("parameter 'file' missing.");
-        
-        ofstream out(*argv, ofstream::trunc);
-        if (out.good()) return main3(argc, ++argv, out);
-        ERROR("output: cannot open/write file.");
+        if (string("-o")       == *argv or
+            string("--output") == *argv)
+        {
+            if (*++argv == nullptr) ERROR("parameter 'file' missing.");
+
+            file.open(*argv, ofstream::trunc);
+            if (not file.good()) ERROR("output: cannot open/write file.");
+            out = &file;
+        }
+        else if (string("-i")      == *argv or
+                 string("--input") == *argv)
+        {
+            if (*++argv == nullptr) ERROR("parameter 'file' missing.");
+
+            opts.input_file = *argv;
+        }
+        else if (string("-e")      == *argv or
+                 string("--exact") == *argv)
+        {
+            opts.exact_degree = true;
+        }
+        else if (string("-v")        == *argv or
+                 string("--verbose") == *argv)
+        {
+            opts.verbose = true;
+        }
+        else if (string("--threads") == *argv)
+        {
+            if (*++argv == nullptr) ERROR("parameter 'N' missing.");
+
+            if (not parse_unsigned(*argv, max_threads, opts.threads)) ERROR("threads: integer of 0 ... ", max_threads, " required.");
+        }
+        else if (string("--format") == *argv)
+        {
+            if (*++argv == nullptr) ERROR("parameter 'format' missing.");
+
+            string const format(*argv);
+            if      (format == "text")   opts.format = OutputFormat::text;
+            else if (format == "csv")    opts.format = OutputFormat::csv;
+            else if (format == "json")   opts.format = OutputFormat::json;
+            else if (format == "binary") opts.format = OutputFormat::binary;
+            else ERROR("format: one of text, csv, json, binary required.");
+        }
+        else if (string("--cache") == *argv)
+        {
+            if (*++argv == nullptr) ERROR("parameter 'dir' missing.");
+
+            opts.cache_dir = *argv;
+        }
+        else if (string("--stats")      == *argv or
+                 string("--stats-json") == *argv)
+        {
+            if (not stats_compiled) ERROR("stats: compiled without counters (MODULUS_NO_STATS).");
+            if (string("--stats-json") == *argv)
+            {
+                if (*++argv == nullptr) ERROR("parameter 'file' missing.");
+                opts.stats_json = *argv;
+            }
+            opts.stats = true;
+        }
+        else if (string("--memory-limit") == *argv)
+        {
+            if (*++argv == nullptr) ERROR("parameter 'MiB' missing.");
+
+            if (not parse_unsigned(*argv, std::numeric_limits<unsigned>::max(), opts.memory_limit))
+                ERROR("memory-limit: non-negative integer of MiB required.");
+        }
+        else break;
     }
-    
-    return main3(argc, argv, cout);
+    Utility::thread_pool(opts.threads);
+
+    return main3(argc, argv, *out, opts);
 }
 
-int main3(int argc, char** argv, std::ostream & out)
+// Parses a non-negative decimal integer <= max into res; the whole of arg must be that number, without a sign.
+bool parse_unsigned(char const * arg, unsigned long max, unsigned & res)
+{
+    if (not std::isdigit(static_cast<unsigned char>(*arg))) return false;
+    char * end = nullptr;
+    errno = 0;
+    unsigned long const n = std::strtoul(arg, &end, 10);
+    if (errno != 0 or *end != '\0' or n > max) return false;
+    res = static_cast<unsigned>(n);
+    return true;
+}
+
+int main3(int argc, char** argv, std::ostream & out, Options const & opts)
 {
     const vector<unsigned> primes = { 2, 3, 5, 7, 11, 13, 17, 19 };
 
+    // Any other prime below 2^31 is served by the runtime modulus Z<0>.
+    const unsigned max_prime = 0x7FFFFFFFu;
+    auto is_supported = [max_prime](unsigned p) { return p <= max_prime and is_prime(p); };
+
     using printPolynomials_t = decltype(printPolynomials<2>);
     using testPolynomials_t  = decltype(testPolynomials<2>);
     
@@ -131,12 +224,13 @@ int main3(int argc, char** argv, std::ostream & out)
         string inp(*argv);
 
         vector<unsigned> ds, ps;
-        if (inp.find(',') == string::npos)
+        bool one_for_all = inp.find(',') == string::npos;
+        if (one_for_all)
         {
             unsigned d;
             istringstream iss(inp);
             if (not (iss >> d)) ERROR("positive integer required.");
-            ds = vector<unsigned>(primes.size(), d);
+            ds = { d };
         }
         else
         {
@@ -161,22 +255,29 @@ int main3(int argc, char** argv, std::ostream & out)
                 if      (pos == 0)              { if (not(iss >>      q) or p > q) ERROR("parameter 'ps': positive integer >= ", p, " required.");      }
                 else if (pos == inp.size() - 1) { if (not(iss >> p     ) or p > q) ERROR("parameter 'ps': positive integer <= ", q, " required.");      }
                 else                            { if (not(iss >> p >> q) or p > q) ERROR("parameter 'ps': positive integers must be ascending."); }
-                for (; p <= q; ++p) if (binary_search(primes.begin(), primes.end(), p)) ps.push_back(p);
+                if (q > max_prime) ERROR("parameter 'ps': primes must be < 2^31.");
+                for (; p <= q; ++p) if (is_supported(p)) ps.push_back(p);
             }
             else
             {
                 for (auto & c : inp) if (c == ',') c = ' ';
                 istringstream iss(inp);
                 unsigned p;
-                while (iss >> p) if (binary_search(primes.begin(), primes.end(), p)) ps.push_back(p);
+                while (iss >> p) if (is_supported(p)) ps.push_back(p);
                 if (iss.bad()) ERROR("positive integer(s) required.");
             }
         }
+        if (one_for_all) ds.assign(ps.size(), ds.front());
         for (auto itd  = ds.begin(),  itp  = ps.begin();
                   itd != ds.end() and itp != ps.end();
                 ++itd,              ++itp)
         {
-            printPolys.at(*itp)(*itd, out);
+            if (printPolys.count(*itp) != 0) printPolys.at(*itp)(*itd, out, opts);
+            else
+            {
+                Z<0>::set_modulus(*itp);
+                printPolynomials<0>(*itd, out, opts);
+            }
         }
         return 0;
     }
@@ -187,8 +288,13 @@ int main3(int argc, char** argv, std::ostream & out)
         if (*(++argv) == nullptr) ERROR("parameter 'p' missing.");
         unsigned p;
         istringstream iss(*argv);
-        if ((iss >> p).bad() or not binary_search(primes.begin(), primes.end(), p)) ERROR("prime number required.");
-        testPolys.at(p)(++argv, out);
+        if (not (iss >> p) or not is_supported(p)) ERROR("prime number < 2^31 required.");
+        if (testPolys.count(p) != 0) testPolys.at(p)(++argv, out, opts);
+        else
+        {
+            Z<0>::set_modulus(p);
+            testPolynomials<0>(++argv, out, opts);
+        }
         return 0;
     }
 
@@ -1,100 +1,214 @@
-#pragma once
-
-#include <iostream>
-#include <chrono>
-
-template<typename TimeT = milliseconds>
-struct measure
-{
-    using namespace std::chrono;
-    using hrc = high_resolution_clock;
-    using rep = typename TimeT::rep;
-
-    template<typename F, typename... Args>
-    static rep execution(F func, Args &&... args)
-    {
-        auto start = hrc::now();
-
-        func(std::forward<Args>(args)...);
-
-        auto duration = duration_cast<TimeT>(hrc::now() - start);
-
-        return duration.count();
-    }
-
-    template<typename TestFunctional, typename F, typename... Args>
-    static rep execution(TestFunctional functional, F func, Args &&... args)
-    {
-        auto start = hrc::now();
-
-        functional(func(std::forward<Args>(args)...));
-
-        auto duration = duration_cast<TimeT>(hrc::now() - start);
-
-        return duration.count();
-    }
-
-    class comparisonResults
-    {
-        rep d1, d2;
-    public:
-        comparisonResults(rep d1, rep d2)
-            : d1(d1), d2(d2) { }
-
-
-        rep first() { return d1; }
-        rep second() { return d2; }
-
-        bool isFirstBest() { return d1 <= d2; }
-        bool isSecondBest() { return d1 => d2; }
-
-        long double relativeDifference()
-        {
-            if (isFirstBest())
-                return 1.0l - (long double)d1 / (long double)d2;
-            else
-                return 1.0l - (long double)d2 / (long double)d1;
-        }
-
-        rep absoluteDifference()
-        {
-            if (isFirstBest())
-                return d2 - d1;
-            else
-                return d1 - d2;
-        }
-
-        static void print(string const & first_name, string const & second_name)
-        {
-            std::cout << first_name  << ": " << std::setw(20) << first()  << "ms" << std::endl;
-            std::cout << second_name << ": " << std::setw(20) << second() << "ms" << std::endl;
-            std::cout << "Difference: " << absoluteDifference() << "ms or " << relativeDifference() * 100.0l  << "%" << std::endl;
-        }
-    };
-
-    template<typename F, typename G, typename... Args>
-    static typename comparisonResults compare(F f, G g, Args &&... args)
-    {
-        auto dur1 = execution(f, args);
-        auto dur2 = execution(g, args);
-
-        return comparisonResults(dur1, dur2);
-    }
-
-    template<typename TestFunctional, typename F>
-    static typename comparisonResults compare(TestFunctional functional, F f, F g)
-    {
-        auto dur1 = execution(functional, f);
-        auto dur2 = execution(functional, g);
-        return comparisonResults(dur1, dur2);
-    }
-
-    template<typename TestFunctional, typename F, typename... Args>
-    static typename comparisonResults compare(TestFunctional functional, F f, F g, Args &&... args)
-    {
-        auto dur1 = execution(functional, f, args...);
-        auto dur2 = execution(functional, g, args...);
-        return comparisonResults(dur1, dur2);
-    }
-};
-
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no measure.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <ratio>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+// Timing of functions in units of TimeT, e. g. measure<>::execution(f, args...) are the milliseconds f(args...) took.
+template<typename TimeT = std::chrono::milliseconds>
+struct measure
+{
+    using hrc = std::chrono::steady_clock;
+    using rep = typename TimeT::rep;
+
+    template<typename F, typename... Args>
+    static rep execution(F func, Args &&... args)
+    {
+        auto start = hrc::now();
+
+        func(std::forward<Args>(args)...);
+
+        auto duration = std::chrono::duration_cast<TimeT>(hrc::now() - start);
+
+        return duration.count();
+    }
+
+    template<typename TestFunctional, typename F, typename... Args>
+    static rep execution_tested(TestFunctional functional, F func, Args &&... args)
+    {
+        auto start = hrc::now();
+
+        functional(func(std::forward<Args>(args)...));
+
+        auto duration = std::chrono::duration_cast<TimeT>(hrc::now() - start);
+
+        return duration.count();
+    }
+
+    // Statistics of repeated runs in units of TimeT.
+    struct statistics
+    {
+        size_t runs     = 0;
+        double min      = 0.0,
+               median   = 0.0,
+               mean     = 0.0,
+               variance = 0.0;  // sample variance
+    };
+
+    // Runs func(args...) warmup times without and then runs times with timing.
+    // The timing has the resolution of TimeT, so the runs should take many units of it; min and median are robust against noise.
+    template<typename F, typename... Args>
+    static statistics repeat(size_t runs, size_t warmup, F func, Args const &... args)
+    {
+        for (size_t i = 0; i < warmup; ++i) func(args...);
+
+        std::vector<double> samples;
+        samples.reserve(runs);
+        for (size_t i = 0; i < runs; ++i)
+        {
+            auto start = hrc::now();
+            func(args...);
+            samples.push_back(std::chrono::duration<double, typename TimeT::period>(hrc::now() - start).count());
+        }
+
+        statistics s;
+        s.runs = runs;
+        if (runs == 0) return s;
+        std::sort(samples.begin(), samples.end());
+        s.min    = samples.front();
+        s.median = runs % 2 == 1 ? samples[runs / 2] : (samples[runs / 2 - 1] + samples[runs / 2]) / 2;
+        for (double x : samples) s.mean += x / runs;
+        for (double x : samples) s.variance += runs > 1 ? (x - s.mean) * (x - s.mean) / (runs - 1) : 0.0;
+        return s;
+    }
+
+    class comparisonResults
+    {
+        rep d1, d2;
+    public:
+        comparisonResults(rep d1, rep d2)
+            : d1(d1), d2(d2) { }
+
+
+        rep first()  const { return d1; }
+        rep second() const { return d2; }
+
+        bool isFirstBest()  const { return d1 <= d2; }
+        bool isSecondBest() const { return d1 >= d2; }
+
+        long double relativeDifference() const
+        {
+            if (d1 == d2) return 0.0l;
+            if (isFirstBest())
+                return 1.0l - (long double)d1 / (long double)d2;
+            else
+                return 1.0l - (long double)d2 / (long double)d1;
+        }
+
+        rep absoluteDifference() const
+        {
+            if (isFirstBest())
+                return d2 - d1;
+            else
+                return d1 - d2;
+        }
+
+        void print(std::string const & first_name, std::string const & second_name) const
+        {
+            std::cout << first_name  << ": " << std::setw(20) << first()  << " units" << std::endl;
+            std::cout << second_name << ": " << std::setw(20) << second() << " units" << std::endl;
+            std::cout << "Difference: " << absoluteDifference() << " units or " << relativeDifference() * 100.0l  << "%" << std::endl;
+        }
+    };
+
+    template<typename F, typename G, typename... Args>
+    static comparisonResults compare(F f, G g, Args &&... args)
+    {
+        auto dur1 = execution(f, args...);
+        auto dur2 = execution(g, args...);
+
+        return comparisonResults(dur1, dur2);
+    }
+
+    template<typename TestFunctional, typename F, typename... Args>
+    static comparisonResults compare_tested(TestFunctional functional, F f, F g, Args &&... args)
+    {
+        auto dur1 = execution_tested(functional, f, args...);
+        auto dur2 = execution_tested(functional, g, args...);
+        return comparisonResults(dur1, dur2);
+    }
+};
+
+// Collects named statistics of measure<TimeT>::repeat and writes them as a table or as JSON,
+// so that runs before and after a change can be compared entry by entry.
+template<typename TimeT = std::chrono::nanoseconds>
+class benchmark_report
+{
+public:
+    using statistics = typename measure<TimeT>::statistics;
+
+    // The unit of all figures, derived from TimeT, so that reports of different TimeT are not mistaken for each other.
+    static std::string unit_name()
+    {
+        using period = typename TimeT::period;
+        if (std::ratio_equal<period, std::nano>::value)  return "ns";
+        if (std::ratio_equal<period, std::micro>::value) return "us";
+        if (std::ratio_equal<period, std::milli>::value) return "ms";
+        if (std::ratio_equal<period, std::ratio<1>>::value) return "s";
+        return std::to_string(period::num) + "/" + std::to_string(period::den) + " s";
+    }
+
+    benchmark_report() : unit(unit_name()) { }
+
+    template<typename F, typename... Args>
+    statistics const & run(std::string const & name, size_t runs, size_t warmup, F func, Args const &... args)
+    {
+        entries.emplace_back(name, measure<TimeT>::repeat(runs, warmup, func, args...));
+        return entries.back().second;
+    }
+
+    void print(std::ostream & out) const
+    {
+        out << std::left << std::setw(48) << "benchmark" << std::right
+            << std::setw(14) << ("min / " + unit) << std::setw(14) << ("median / " + unit) << std::setw(16) << ("stddev / " + unit) << std::endl;
+        for (auto const & e : entries)
+            out << std::left << std::setw(48) << e.first << std::right << std::fixed << std::setprecision(1)
+                << std::setw(14) << e.second.min << std::setw(14) << e.second.median << std::setw(16) << std::sqrt(e.second.variance)
+                << std::defaultfloat << std::endl;
+    }
+
+    void write_json(std::ostream & out) const
+    {
+        out << "{\"unit\": \"" << unit << "\", \"benchmarks\": [";
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            auto const & s = entries[i].second;
+            out << (i == 0 ? "\n" : ",\n") << "  {\"name\": \"" << entries[i].first << "\", \"runs\": " << s.runs
+                << std::setprecision(17) << ", \"min\": " << s.min << ", \"median\": " << s.median
+                << ", \"mean\": " << s.mean << ", \"variance\": " << s.variance << "}";
+        }
+        out << "\n]}" << std::endl;
+    }
+
+private:
+    std::string                                     unit;
+    std::vector<std::pair<std::string, statistics>> entries;
+};
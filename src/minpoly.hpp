@@ -0,0 +1,169 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <random>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "irreducibility.hpp"
+#include "linalg.hpp"
+#include "rank_sieve.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+using std::uint64_t;
+
+// Direct generation of the irreducible polynomials of (Z/pZ)[x] of one degree n, without any lower degree.
+// The irreducible polynomials of degree n are the minimal polynomials of the elements of GF(p^n) that lie in no proper subfield.
+// Each of them has n roots, which form one orbit of the Frobenius map a -> a^p.
+// In a normal basis (t, t^p, ..., t^(p^(n-1))) of GF(p^n), the Frobenius map is the cyclic shift of the coordinates.
+// So the orbits of size n are represented exactly once by the Lyndon words of length n over the alphabet Z/pZ.
+
+// The Moebius function.
+inline int moebius(unsigned n)
+{
+    int res = 1;
+    for (unsigned q = 2; q * q <= n; ++q)
+    {
+        if (n % q != 0) continue;
+        n /= q;
+        if (n % q == 0) return 0;
+        res = -res;
+    }
+    return n > 1 ? -res : res;
+}
+
+// Number of monic irreducible polynomials of (Z/pZ)[x] of degree n (Gauss' formula), (1/n) * sum over d | n of moebius(d) p^(n/d).
+// The constant polynomial 1 is counted as the only one of degree 0.
+template <unsigned p>
+uint64_t irreducible_count(unsigned n)
+{
+    if (n == 0) return 1;
+    auto power = [](unsigned e) { uint64_t r = 1;  while (e-- > 0) r *= Z<p>::modulus();  return r; };
+
+    uint64_t pos = 0, neg = 0;
+    for (unsigned d = 1; d <= n; ++d)
+    {
+        if (n % d != 0) continue;
+        int const mu = moebius(d);
+        if      (mu > 0) pos += power(n / d);
+        else if (mu < 0) neg += power(n / d);
+    }
+    return (pos - neg) / n;
+}
+
+// Returns the irreducible polynomial of degree n with the smallest rank.
+template <unsigned p>
+Polynomial<Z<p>> find_irreducible(unsigned n)
+{
+    for (uint64_t r = 0; ; ++r)
+    {
+        auto f = unrank<p>(r, n);
+        if (is_irreducible(f)) return f;
+    }
+}
+
+// Returns the normal basis t, t^p, ..., t^(p^(n-1)) of GF(p^n) = (Z/pZ)[x] / f for some t.
+template <unsigned p>
+vector<Polynomial<Z<p>>> normal_basis(Polynomial<Z<p>> const & f)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+    size_t const n = deg(f);
+
+    std::mt19937_64 rng(n);
+    while (true)
+    {
+        vector<K> coeffs(n);
+        for (auto & c : coeffs) c = K(static_cast<unsigned>(rng() % K::modulus()));
+
+        vector<KPoly> conj = { KPoly::fromCoeffVector(coeffs) };
+        for (size_t i = 1; i < n; ++i) conj.push_back(powmod(conj.back(), K::modulus(), f));
+
+        // The conjugates form a basis iff the matrix of their coordinates is regular.
+        vector<vector<K>> m(n, vector<K>(n));
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) m[j][i] = conj[i].at(j);
+        if (null_space(std::move(m)).empty()) return conj;
+    }
+}
+
+// Returns the minimal polynomial of a in GF(p^n) = (Z/pZ)[x] / f, assuming it has degree n.
+// Solves the linear dependency of 1, a, ..., a^n.
+template <unsigned p>
+Polynomial<Z<p>> minimal_polynomial(Polynomial<Z<p>> const & a, Polynomial<Z<p>> const & f)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+    size_t const n = deg(f);
+
+    vector<vector<K>> m(n, vector<K>(n + 1));
+    KPoly power(K(1));
+    for (size_t i = 0; i <= n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j) m[j][i] = power.at(j);
+        power = power * a % f;
+    }
+
+    // As 1, a, ..., a^(n-1) are linearly independent, the null space is spanned by one vector v with v[n] != 0.
+    auto v = null_space(std::move(m)).front();
+    K const inv_lead = K(1) / v[n];
+    for (auto & c : v) c *= inv_lead;
+    return KPoly::fromCoeffVector(v);
+}
+
+// Calls func(g) for every irreducible polynomial g of (Z/pZ)[x] of degree n.
+// Memory is independent of the number of polynomials; no polynomial of lower degree is needed.
+template <unsigned p, typename Func>
+void for_each_irreducible_of_degree(unsigned n, Func && func)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+
+    if (n == 0) { func(KPoly(K(1)));  return; }
+
+    KPoly const         f     = find_irreducible<p>(n);
+    vector<KPoly> const basis = normal_basis<p>(f);
+
+    // Duval's algorithm enumerates the Lyndon words of length <= n in lexicographic order.
+    vector<unsigned> w = { 0 };
+    while (not w.empty())
+    {
+        if (w.size() == n)
+        {
+            KPoly a;
+            for (size_t i = 0; i < n; ++i) if (w[i] != 0) a += basis[i] * K(w[i]);
+            func(minimal_polynomial<p>(a, f));
+        }
+
+        size_t const m = w.size();
+        while (w.size() < n) w.push_back(w[w.size() - m]);
+        while (not w.empty() and w.back() == K::modulus() - 1) w.pop_back();
+        if (not w.empty()) ++w.back();
+    }
+}
+
+} // namespace Modulus
@@ -0,0 +1,163 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no ntt.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// Multiplication of polynomials with coefficients modulo any q < 2^32 by the number theoretic transform (NTT).
+// The product is computed exactly over the integers: as convolutions modulo up to three primes P = c 2^k + 1 < 2^30,
+// combined by the Chinese remainder theorem (Garner's algorithm) and finally reduced modulo q.
+// Three primes cover coefficients up to about 2^86, i. e. any q < 2^32 and up to 2^22 coefficients.
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+namespace Modulus { namespace Utility
+{
+
+// Arithmetic modulo the prime P = c 2^k + 1 with the primitive root G and the transforms of lengths 2^j <= 2^k.
+template <std::uint32_t P, std::uint32_t G, unsigned k>
+struct NttPrime
+{
+    static constexpr std::uint32_t modulus    = P;
+    static constexpr std::size_t   max_length = std::size_t(1) << k;
+
+    static std::uint32_t add(std::uint32_t a, std::uint32_t b) noexcept { std::uint32_t s = a + b;  return s >= P ? s - P : s; }
+    static std::uint32_t sub(std::uint32_t a, std::uint32_t b) noexcept { return a >= b ? a - b : a + P - b; }
+    static std::uint32_t mul(std::uint32_t a, std::uint32_t b) noexcept { return static_cast<std::uint32_t>(std::uint64_t(a) * b % P); }
+
+    static std::uint32_t pow(std::uint32_t a, std::uint64_t e) noexcept
+    {
+        std::uint32_t r = 1;
+        for (; e != 0; e >>= 1, a = mul(a, a)) if (e & 1) r = mul(r, a);
+        return r;
+    }
+    static std::uint32_t inv(std::uint32_t a) noexcept { return pow(a, P - 2); }
+
+    // In place transform of a, whose size is a power of two <= max_length. The inverse includes the division by the size.
+    static void transform(std::vector<std::uint32_t> & a, bool inverse)
+    {
+        std::size_t const n = a.size();
+        for (std::size_t i = 1, j = 0; i < n; ++i)
+        {
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+
+        std::vector<std::uint32_t> twiddle(n / 2);
+        for (std::size_t len = 2; len <= n; len *= 2)
+        {
+            std::uint32_t const w = pow(inverse ? inv(G) : G, (P - 1) / len);
+            std::size_t   const h = len / 2;
+            twiddle[0] = 1;
+            for (std::size_t j = 1; j < h; ++j) twiddle[j] = mul(twiddle[j - 1], w);
+
+            for (std::size_t i = 0; i < n; i += len)
+                for (std::size_t j = 0; j < h; ++j)
+                {
+                    std::uint32_t const u = a[i + j],
+                                        v = mul(a[i + j + h], twiddle[j]);
+                    a[i + j]     = add(u, v);
+                    a[i + j + h] = sub(u, v);
+                }
+        }
+
+        if (inverse)
+        {
+            std::uint32_t const n_inv = inv(static_cast<std::uint32_t>(n % P));
+            for (auto & x : a) x = mul(x, n_inv);
+        }
+    }
+
+    // Returns a[0 .. na) * b[0 .. nb) modulo P; na + nb - 1 must not exceed max_length.
+    template <typename T>
+    static std::vector<std::uint32_t> convolution(T const * a, std::size_t na, T const * b, std::size_t nb)
+    {
+        std::size_t n = 1;
+        while (n < na + nb - 1) n *= 2;
+
+        std::vector<std::uint32_t> fa(n, 0), fb(n, 0);
+        for (std::size_t i = 0; i < na; ++i) fa[i] = static_cast<std::uint32_t>(a[i] % P);
+        for (std::size_t i = 0; i < nb; ++i) fb[i] = static_cast<std::uint32_t>(b[i] % P);
+        transform(fa, false);
+        transform(fb, false);
+        for (std::size_t i = 0; i < n; ++i) fa[i] = mul(fa[i], fb[i]);
+        transform(fa, true);
+        fa.resize(na + nb - 1);
+        return fa;
+    }
+};
+
+using NttPrime1 = NttPrime<998244353u, 3u, 23>;   // 119 * 2^23 + 1
+using NttPrime2 = NttPrime<469762049u, 3u, 26>;   //   7 * 2^26 + 1
+using NttPrime3 = NttPrime<167772161u, 3u, 25>;   //   5 * 2^25 + 1
+
+// The maximal number of coefficients of a product computed by ntt_multiply.
+constexpr std::size_t ntt_max_length() noexcept { return NttPrime1::max_length; }
+
+// r[0 .. na + nb - 1) = a[0 .. na) * b[0 .. nb) modulo q for coefficients a[i], b[j] < q.
+// Uses as few primes as the bound min(na, nb) (q - 1)^2 of the coefficients of the integer product allows.
+template <typename T>
+void ntt_multiply(T * r, T const * a, std::size_t na, T const * b, std::size_t nb, std::uint32_t q)
+{
+    using P1 = NttPrime1;
+    using P2 = NttPrime2;
+    using P3 = NttPrime3;
+
+    std::size_t       const n     = na + nb - 1;
+    unsigned __int128 const bound = static_cast<unsigned __int128>(std::uint64_t(q - 1) * (q - 1)) * std::min(na, nb);
+    unsigned __int128 const p12   = static_cast<unsigned __int128>(P1::modulus) * P2::modulus;
+    unsigned const primes = bound < P1::modulus ? 1 : bound < p12 ? 2 : 3;
+
+    std::vector<std::uint32_t> const c1 = P1::convolution(a, na, b, nb);
+    std::vector<std::uint32_t>       c2, c3;
+    if (primes > 1) c2 = P2::convolution(a, na, b, nb);
+    if (primes > 2) c3 = P3::convolution(a, na, b, nb);
+
+    // Garner: x = x1 + P1 y2 + P1 P2 y3 with x1 < P1, y2 < P2, y3 < P3.
+    std::uint32_t const inv_p1_p2  = P2::inv(P1::modulus % P2::modulus),
+                        inv_p1_p3  = P3::inv(P1::modulus % P3::modulus),
+                        inv_p2_p3  = P3::inv(P2::modulus % P3::modulus);
+    std::uint64_t const p1_q       = P1::modulus % q,
+                        p12_q      = static_cast<std::uint64_t>(p12 % q);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::uint64_t x = c1[i] % q;
+        if (primes > 1)
+        {
+            std::uint32_t const y2 = P2::mul(P2::sub(c2[i], c1[i] % P2::modulus), inv_p1_p2);
+            x += p1_q * y2 % q;
+            if (primes > 2)
+            {
+                std::uint32_t const d  = P3::sub(c3[i], c1[i] % P3::modulus),
+                                    y3 = P3::mul(P3::sub(P3::mul(d, inv_p1_p3), y2 % P3::modulus), inv_p2_p3);
+                x += p12_q * y3 % q;
+            }
+        }
+        r[i] = static_cast<T>(x % q);
+    }
+}
+
+}} // namespace Modulus::Utility
@@ -0,0 +1,53 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no options.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <string>
+
+namespace Modulus
+{
+
+// The formats of the polynomials listed by -l.
+enum class OutputFormat
+{
+    text,    // human readable, one polynomial per line under a header per degree
+    csv,     // one line p,degree,rank,polynomial per polynomial
+    json,    // one object with an array of polynomials per degree
+    binary   // a header and the ranks of the polynomials as 64 bit words per degree
+};
+
+// The options set on the command line before the command (-l, -t).
+struct Options
+{
+    bool     exact_degree = false;  // -e: list only the polynomials of the given degree, not of all degrees up to it
+    unsigned threads      = 0;      // --threads: size of the thread pool, 0 means one thread per hardware thread
+    bool     verbose      = false;  // -v: print statistics like the throughput of the sieve on the error stream
+    unsigned memory_limit = 0;      // --memory-limit: MiB the sieve may allocate, 0 means unlimited
+    std::string cache_dir;          // --cache: directory of the SieveCache, empty means no cache
+    std::string input_file;         // -i: file of further polynomials for -t, "-" is the standard input
+    OutputFormat format = OutputFormat::text;  // --format: format of the polynomials listed by -l
+    bool     stats        = false;  // --stats: count the work of the sieve per degree and partition
+    std::string stats_json;         // --stats-json: file the counters of --stats are written to, empty means the error stream
+};
+
+} // namespace Modulus
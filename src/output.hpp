@@ -0,0 +1,230 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "rank_sieve.hpp"
+#include "options.hpp"
+
+namespace Modulus
+{
+namespace Utility
+{
+
+// Collects the output in a large buffer and hands it to the stream in blocks, without any flush per line.
+// Numbers are formatted in place, so writing does not allocate.
+class BufferedWriter
+{
+public:
+    explicit BufferedWriter(std::ostream & out, size_t capacity = size_t(1) << 20) : out(out), buffer(capacity), pos(0) { }
+    ~BufferedWriter() { flush(); }
+
+    BufferedWriter(BufferedWriter const &) = delete;
+    BufferedWriter & operator =(BufferedWriter const &) = delete;
+
+    // Hands the buffer to the stream and flushes it.
+    void flush()
+    {
+        out.write(buffer.data(), pos);
+        out.flush();
+        pos = 0;
+    }
+
+    BufferedWriter & put(char c)
+    {
+        if (pos == buffer.size()) drain();
+        buffer[pos++] = c;
+        return *this;
+    }
+
+    BufferedWriter & write(char const * s, size_t n)
+    {
+        if (n > buffer.size() - pos) drain();
+        if (n > buffer.size()) out.write(s, n);
+        else { std::memcpy(buffer.data() + pos, s, n);  pos += n; }
+        return *this;
+    }
+
+    template <size_t N>
+    BufferedWriter & write(char const (& s)[N]) { return write(s, N - 1); }
+
+    // Writes the decimal digits of n.
+    BufferedWriter & write(std::uint64_t n)
+    {
+        char digits[20];
+        size_t k = sizeof digits;
+        do { digits[--k] = static_cast<char>('0' + n % 10);  n /= 10; } while (n != 0);
+        return write(digits + k, sizeof digits - k);
+    }
+
+    // Writes the bytes of a trivially copyable value in the byte order of the machine.
+    template <typename T>
+    BufferedWriter & write_raw(T const & t) { return write(reinterpret_cast<char const *>(&t), sizeof t); }
+
+private:
+    std::ostream &    out;
+    std::vector<char> buffer;
+    size_t            pos;
+
+    void drain()
+    {
+        out.write(buffer.data(), pos);
+        pos = 0;
+    }
+};
+
+} // namespace Utility
+
+// Writes f like operator <<, e. g. "x^4 + 2x^2 + 1", but without any temporary string.
+template <typename KPoly>
+void write_polynomial(Utility::BufferedWriter & w, KPoly const & f)
+{
+    bool first = true;
+    for (size_t i = deg(f) + 1; i-- > 0; )
+    {
+        unsigned const c = static_cast<unsigned>(f.at(i));
+        if (c == 0 and not (i == 0 and first)) continue;
+        if (not first) w.write(" + ");
+        first = false;
+
+        if (c != 1 or i == 0) w.write(std::uint64_t(c));
+        if (i >= 1) w.put('x');
+        if (i >= 2) w.put('^').write(std::uint64_t(i));
+    }
+}
+
+// Writes the irreducible polynomials listed by -l in one of the OutputFormats:
+//  text:   the header "Irreducible Polynomials modulo p of degree up to n (count):", then per degree "Degree d (count):",
+//          one polynomial per line and an empty line. With -e there is only one degree, so its header line is omitted.
+//  csv:    the line "p,degree,rank,polynomial", then one such line per polynomial.
+//  json:   {"p": p, "degree": n, "count": count, "degrees": [{"degree": d, "count": count, "polynomials": ["x + 1", ...]}, ...]}
+//  binary: the magic "MODPOLY1", p and n as 32 bit words, then per degree d and the count as 32 and 64 bit words,
+//          followed by the ranks (see rank_sieve.hpp) of the polynomials as 64 bit words, all in the byte order of the machine.
+// Calls must be begin, then degree, poly ..., end_degree for every degree, then end.
+template <unsigned p>
+class PolynomialWriter
+{
+public:
+    PolynomialWriter(std::ostream & out, OutputFormat format) : w(out), format(format) { }
+
+    void begin(unsigned n, std::uint64_t count, bool exact)
+    {
+        this->exact = exact;
+        std::uint64_t const q = Z<p>::modulus();
+        switch (format)
+        {
+        case OutputFormat::text:
+            w.write("Irreducible Polynomials modulo ").write(q);
+            if (exact) w.write(" of degree ");
+            else       w.write(" of degree up to ");
+            w.write(std::uint64_t(n)).write(" (").write(count).write("):\n");
+            break;
+        case OutputFormat::csv:
+            w.write("p,degree,rank,polynomial\n");
+            break;
+        case OutputFormat::json:
+            w.write("{\"p\": ").write(q).write(", \"degree\": ").write(std::uint64_t(n)).write(", \"count\": ").write(count);
+            w.write(", \"degrees\": [");
+            break;
+        case OutputFormat::binary:
+            w.write("MODPOLY1").write_raw(static_cast<std::uint32_t>(q)).write_raw(static_cast<std::uint32_t>(n));
+            break;
+        }
+        first_degree = true;
+    }
+
+    void degree(unsigned d, std::uint64_t count)
+    {
+        this->d = d;
+        switch (format)
+        {
+        case OutputFormat::text:
+            if (not exact) w.write("Degree ").write(std::uint64_t(d)).write(" (").write(count).write("):\n");
+            break;
+        case OutputFormat::csv:
+            break;
+        case OutputFormat::json:
+            if (not first_degree) w.put(',');
+            w.write("\n  {\"degree\": ").write(std::uint64_t(d)).write(", \"count\": ").write(count).write(", \"polynomials\": [");
+            break;
+        case OutputFormat::binary:
+            w.write_raw(static_cast<std::uint32_t>(d)).write_raw(count);
+            break;
+        }
+        first_degree = false;
+        first_poly   = true;
+    }
+
+    void poly(Polynomial<Z<p>> const & f)
+    {
+        switch (format)
+        {
+        case OutputFormat::text:
+            write_polynomial(w, f);
+            w.put('\n');
+            break;
+        case OutputFormat::csv:
+            w.write(std::uint64_t(Z<p>::modulus())).put(',').write(std::uint64_t(d)).put(',').write(rank<p>(f)).put(',');
+            write_polynomial(w, f);
+            w.put('\n');
+            break;
+        case OutputFormat::json:
+            if (not first_poly) w.write(", ");
+            w.put('"');
+            write_polynomial(w, f);
+            w.put('"');
+            break;
+        case OutputFormat::binary:
+            w.write_raw(rank<p>(f));
+            break;
+        }
+        first_poly = false;
+    }
+
+    void end_degree()
+    {
+        if      (format == OutputFormat::text) w.put('\n');
+        else if (format == OutputFormat::json) w.put(']').put('}');
+    }
+
+    void end()
+    {
+        if (format == OutputFormat::json) w.write("\n]}\n");
+        w.flush();
+    }
+
+private:
+    Utility::BufferedWriter w;
+    OutputFormat            format;
+    bool                    exact        = false,
+                            first_degree = true,
+                            first_poly   = true;
+    unsigned                d            = 0;
+};
+
+} // namespace Modulus
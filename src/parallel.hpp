@@ -1,40 +1,251 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no parallel.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
 #include <vector>
+#include <deque>
+#include <memory>
 
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
+#include <iterator>
 #include <functional>
 #include <algorithm>
 
+namespace Modulus { namespace Utility
+{
 
+using std::vector;
 
-template <template <typename, typename...> class Container, typename Item, typename... Ts, typename Func>
-void FOR_EACH_PAR(Container<Item, Ts...> const & cont, Func && func)
+// A persistent pool of worker threads with one task queue per thread.
+// A thread takes the newest task of its own queue and, if that is empty, steals the oldest task of another queue.
+// Tasks may spawn further tasks, which land in the queue of the spawning thread.
+// The thread waiting for a TaskGroup executes tasks as well, so a pool of size n has n - 1 worker threads.
+class ThreadPool
 {
-    using Cont = Container<Item, Ts...>;
-    
-    size_t const size = cont.size();
-    
-    size_t const max_threads = std::max(static_cast<size_t>(1),
-                                        std::min(size,
-                                                 static_cast<size_t>(std::thread::hardware_concurrency())));
-    std::vector<std::thread> threads;
-    threads.reserve(max_threads);
-    
-    size_t inc = size / max_threads;
-    size_t rem = size % max_threads;
-
-    auto beg = cont.begin();
-    auto end = cont.end();
-
-    while (beg != end)
-    {
-        auto it = beg;
-        beg += (rem > 0  ?  --rem, inc + 1  :  inc);
-        
-        threads.emplace_back(std::bind(std::for_each<typename Cont::const_iterator, Func>, it, beg, func));
-        
-    }
-
-    for (auto & t : threads) t.join();
-    
+public:
+    using Task = std::function<void()>;
+
+    // Counts the unfinished tasks spawned into it.
+    class TaskGroup
+    {
+        friend class ThreadPool;
+        std::atomic<size_t> pending { 0 };
+    };
+
+    // threads == 0 means one thread per hardware thread.
+    explicit ThreadPool(unsigned threads = 0)
+    {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i) queues.emplace_back(new Queue);
+        for (unsigned i = 1; i < threads; ++i) workers.emplace_back([this, i] { work(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto & t : workers) t.join();
+    }
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool & operator =(ThreadPool const &) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    // The number of times a thread had to wait for the lock of a task queue, for the counters of --stats.
+    size_t lock_waits() const { return contended.load(std::memory_order_relaxed); }
+
+    // The index 0 ... size() - 1 of the calling thread in the pool. Threads outside of the pool share index 0.
+    // Tasks may use it to address per thread data without locking, as a thread executes one task at a time.
+    size_t thread_index() const { return self(); }
+
+    void spawn(TaskGroup & group, Task task)
+    {
+        group.pending.fetch_add(1);
+        {
+            Queue & q = *queues[self()];
+            auto lock = lock_counted(q.mutex);
+            q.tasks.emplace_back(std::move(task), &group);
+        }
+        queued.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        wake.notify_one();
+    }
+
+    // Returns when every task of the group has finished. Meanwhile the calling thread executes tasks.
+    void wait(TaskGroup & group)
+    {
+        size_t const i = self();
+        while (group.pending.load() != 0)
+        {
+            if (run_one(i)) continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            if (group.pending.load() != 0 and queued.load() == 0) wake.wait(lock);
+        }
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex                               mutex;
+        std::deque<std::pair<Task, TaskGroup *>> tasks;
+    };
+
+    vector<std::unique_ptr<Queue>> queues;  // queues[0] belongs to the threads outside of the pool
+    vector<std::thread>            workers;
+
+    std::mutex              sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<size_t>     queued { 0 };
+    std::atomic<size_t>     contended { 0 };
+    bool                    stop = false;
+
+    // The pool and the queue index of the current thread.
+    static std::pair<ThreadPool const *, size_t> & current()
+    {
+        thread_local std::pair<ThreadPool const *, size_t> cur(nullptr, 0);
+        return cur;
+    }
+
+    size_t self() const { return current().first == this ? current().second : 0; }
+
+    // Locks m and counts the locks which had to wait, unless the counters are compiled out by MODULUS_NO_STATS.
+    std::unique_lock<std::mutex> lock_counted(std::mutex & m)
+    {
+#ifndef MODULUS_NO_STATS
+        std::unique_lock<std::mutex> lock(m, std::try_to_lock);
+        if (lock.owns_lock()) return lock;
+        contended.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+        return lock;
+#else
+        return std::unique_lock<std::mutex>(m);
+#endif
+    }
+
+    void work(size_t i)
+    {
+        current() = { this, i };
+        while (true)
+        {
+            if (run_one(i)) continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            while (not stop and queued.load() == 0) wake.wait(lock);
+            if (stop) return;
+        }
+    }
+
+    // Executes one task of the own queue or stolen from another one. Returns false if there is none.
+    bool run_one(size_t i)
+    {
+        std::pair<Task, TaskGroup *> job;
+        bool found = false;
+        for (size_t k = 0; k < queues.size() and not found; ++k)
+        {
+            Queue & q = *queues[(i + k) % queues.size()];
+            auto lock = lock_counted(q.mutex);
+            if (q.tasks.empty()) continue;
+            if (k == 0) { job = std::move(q.tasks.back());   q.tasks.pop_back();  }
+            else        { job = std::move(q.tasks.front());  q.tasks.pop_front(); }
+            found = true;
+        }
+        if (not found) return false;
+
+        queued.fetch_sub(1);
+        job.first();
+        if (job.second->pending.fetch_sub(1) == 1)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+            }
+            wake.notify_all();
+        }
+        return true;
+    }
+};
+
+// The pool used by the parallel algorithms. It lives for the whole run.
+// The first call determines the number of threads, 0 means one per hardware thread.
+inline ThreadPool & thread_pool(unsigned threads = 0)
+{
+    static ThreadPool pool(threads);
+    return pool;
 }
+
+// Splits the iteration of iterator_multi_increment_delta over the ranges [begs[i], ends[i]) into parts (sub_begs, sub_ends).
+// The parts fix the outermost (last) iterator. The iterators before it which iterate the same range start at its value then.
+// If no iterator shares the range of the outermost one, consecutive values of it are combined to parts of about grain combinations.
+template <typename Iterator>
+vector<std::pair<vector<Iterator>, vector<Iterator>>> split_multi_increment(vector<Iterator> const & begs,
+                                                                            vector<Iterator> const & ends,
+                                                                            size_t                   grain = 1024)
+{
+    vector<std::pair<vector<Iterator>, vector<Iterator>>> parts;
+    if (begs.empty()) return parts;
+    size_t const last    = begs.size() - 1;
+    bool   const coupled = last > 0 and begs[last - 1] == begs[last];
+
+    size_t inner = 1;
+    for (size_t i = 0; i < last and inner < grain; ++i)
+        inner *= std::max<size_t>(1, std::distance(begs[i], ends[i]));
+    size_t const chunk = coupled ? 1 : std::max<size_t>(1, grain / inner);
+
+    for (auto it = begs[last]; it != ends[last]; )
+    {
+        vector<Iterator> sub_begs = begs,
+                         sub_ends = ends;
+        sub_begs[last] = it;
+        for (size_t c = 0; c < chunk and it != ends[last]; ++c) ++it;
+        sub_ends[last] = it;
+        if (coupled)
+            for (size_t i = last; i-- > 0 and begs[i] == begs[last]; ) sub_begs[i] = sub_begs[last];
+
+        parts.emplace_back(std::move(sub_begs), std::move(sub_ends));
+    }
+    return parts;
+}
+
+// Spawns a task calling func(sub_begs, sub_ends) for every part of split_multi_increment into the group.
+// func must stay valid until the group has finished.
+template <typename Iterator, typename Func>
+void spawn_multi_increment_parts(ThreadPool            & pool,
+                                 ThreadPool::TaskGroup & group,
+                                 vector<Iterator> const & begs,
+                                 vector<Iterator> const & ends,
+                                 Func const &             func,
+                                 size_t                   grain = 1024)
+{
+    for (auto & part : split_multi_increment(begs, ends, grain))
+        pool.spawn(group, [&func, part] { func(part.first, part.second); });
+}
+
+}} // namespace Modulus::Utility
@@ -0,0 +1,172 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no parse.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Modulus
+{
+namespace Utility
+{
+
+// Degrees above this are rejected by parse_polynomial rather than allocated.
+// 2^24 coefficients are far beyond what -t can test, and well below the 32 bit length of small_vector.
+constexpr std::uint64_t max_parse_degree = (std::uint64_t(1) << 24) - 1;
+
+// Parses a polynomial with coefficients modulo q from [first, last) in a single pass, without any allocation.
+// The format is that of operator <<: monomials ax^d, x^d, ax, x or a, joined by + or - and optionally led by a sign,
+// e. g. "x^4 + 2x^2 - 1" or "x^4+2x^2-1". Blanks are allowed around the signs only.
+// Coefficients are reduced modulo q, so "-1" is q - 1. Degrees above max_parse_degree are not well formed.
+// Calls add(d, a) for every monomial, with 0 <= a < q; monomials of the same degree are meant to be added.
+// Stops at the first character which does not continue the polynomial and sets first to it.
+// Returns false if [first, last) does not start with a well formed polynomial.
+template <typename Add>
+bool parse_polynomial(char const *& first, char const * last, std::uint64_t q, Add && add)
+{
+    auto digit  = [&first, last] { return first != last and *first >= '0' and *first <= '9'; };
+    auto blanks = [&first, last] { while (first != last and (*first == ' ' or *first == '\t')) ++first; };
+    auto coeff  = [&first, &digit, q](std::uint64_t & n)
+    {
+        if (not digit()) return false;
+        for (n = 0; digit(); ++first) n = (n * 10 + static_cast<unsigned>(*first - '0')) % q;
+        return true;
+    };
+    auto degree = [&first, &digit](std::uint64_t & n)
+    {
+        if (not digit()) return false;
+        for (n = 0; digit(); ++first)
+        {
+            unsigned const c = static_cast<unsigned>(*first - '0');
+            if (n > (max_parse_degree - c) / 10) return false;
+            n = n * 10 + c;
+        }
+        return true;
+    };
+
+    bool any = false;
+    while (first != last)
+    {
+        char const * const before = first;
+        if (any) blanks();
+
+        bool negative = false;
+        if      (first != last and *first == '+')  ++first;
+        else if (first != last and *first == '-') { ++first;  negative = true; }
+        else if (any)                             { first = before;  break; }
+        if (first != before) blanks();
+
+        std::uint64_t a = 1, d = 0;
+        bool const has_coeff = coeff(a);
+        if (first != last and *first == 'x')
+        {
+            ++first;
+            d = 1;
+            if (first != last and *first == '^')
+            {
+                ++first;
+                if (not degree(d)) return false;
+            }
+        }
+        else if (not has_coeff) return false;
+
+        add(static_cast<size_t>(d), negative and a != 0 ? q - a : a);
+        any = true;
+    }
+    return any;
+}
+
+// Calls func(first, last) for every non-empty line of the file with the given name, "-" is the standard input.
+// Blanks and a carriage return around a line are not passed on, so the polynomials printed by -l may be read back.
+// Regular files are memory-mapped, so their lines are read in place; others, like pipes, are read in blocks.
+// Returns false if the file cannot be opened.
+template <typename Func>
+bool for_each_line(std::string const & name, Func && func)
+{
+    auto space = [](char c) { return c == ' ' or c == '\t' or c == '\r' or c == '\v' or c == '\f'; };
+
+    // Calls func for the complete lines of [first, last) and returns the start of the trailing incomplete one.
+    auto lines = [&space, &func](char const * first, char const * last, bool complete)
+    {
+        while (true)
+        {
+            char const * end = std::find(first, last, '\n');
+            if (end == last and not complete) return first;
+
+            char const * b = first, * e = end;
+            while (b != e and space(*b))     ++b;
+            while (e != b and space(e[-1])) --e;
+            if (b != e) func(b, e);
+            if (end == last) return last;
+            first = end + 1;
+        }
+    };
+
+    int const fd = name == "-" ? STDIN_FILENO : ::open(name.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and st.st_size > 0)
+    {
+        size_t const size = static_cast<size_t>(st.st_size);
+        void * const addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            ::madvise(addr, size, MADV_SEQUENTIAL);
+            char const * const data = static_cast<char const *>(addr);
+            lines(data, data + size, true);
+            ::munmap(addr, size);
+            if (fd != STDIN_FILENO) ::close(fd);
+            return true;
+        }
+    }
+
+    // The buffer grows only if a single line does not fit.
+    std::vector<char> buffer(size_t(1) << 20);
+    size_t filled = 0;
+    while (true)
+    {
+        if (filled == buffer.size()) buffer.resize(2 * buffer.size());
+        ssize_t const got = ::read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (got < 0) break;
+        filled += static_cast<size_t>(got);
+
+        char const * const rest = lines(buffer.data(), buffer.data() + filled, got == 0);
+        if (got == 0) break;
+        filled -= rest - buffer.data();
+        std::copy(rest, rest + filled, buffer.data());
+    }
+    if (fd != STDIN_FILENO) ::close(fd);
+    return true;
+}
+
+}} // namespace Modulus::Utility
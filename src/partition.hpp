@@ -0,0 +1,70 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no partition.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ * 
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+namespace Modulus
+{
+
+using std::vector;
+
+// Returns the vector of non-trivial additive decompositions of the given number.
+// A positive integer number n can be written as a sum of positive values.
+// Every decomposition is stored as vector of addends.
+// The decomposition of n as just n is the trivial decomposition.
+// The function only returns different decompositions respecting that permutations of addends provide the same decomposition.
+// The only decomposition of zero is the empty vector of addends.
+vector<vector<unsigned>> decomp(unsigned n)
+{
+    // (Haskell with ViewPatterns)
+    // deComp :: Integer -> [[Integer]]
+    // deComp x = d x x where
+    //    d 0  _           = [[]]
+    //    d n (min n -> m) = [ i : dec | i <- [1 .. m], dec <- d (n - i) i ]
+    //
+    using vvu = vector<vector<unsigned>>;
+    std::function<vvu(unsigned, unsigned)> d = 
+        [&d] (unsigned n, unsigned limit)
+        {
+            if (n == 0) return vvu(1);
+
+            vvu result;
+            unsigned m = std::min(n, limit);
+            for (unsigned i = 1; i <= m; ++i)
+            for (auto & dec : d(n - i, i)) // recursion
+            {
+                dec.push_back(i);
+                result.push_back(dec);
+            }
+            return result;
+        };
+
+    auto dec = d(n, n);
+    dec.pop_back(); // the last one is always n itself. We don't need it, and it is IMPORTANT to drop it.
+    return dec;
+}
+
+} // namespace Modulus
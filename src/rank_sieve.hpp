@@ -0,0 +1,363 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "container.hpp"
+#include "partition.hpp"
+#include "parallel.hpp"
+#include "schedule.hpp"
+#include "counters.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+using std::uint64_t;
+
+// The rank of a monic polynomial f of degree d is the p-adic number whose digits are the non-leading coefficients of f,
+//    rank(x^d + c[d-1] x^(d-1) + ... + c[0])  =  c[d-1] p^(d-1) + ... + c[1] p + c[0].
+// This is the order in which the p-adic increment of the sieve generates the polynomials.
+// Therefore the monic polynomials of degree d are exactly the ranks 0 ... p^d - 1.
+template <unsigned p>
+uint64_t rank(Polynomial<Z<p>> const & f)
+{
+    uint64_t r = 0;
+    for (size_t i = deg(f); i-- > 0; ) r = r * Z<p>::modulus() + static_cast<unsigned>(f.at(i));
+    return r;
+}
+
+// Returns the monic polynomial of degree d with the given rank.
+template <unsigned p>
+Polynomial<Z<p>> unrank(uint64_t r, unsigned d)
+{
+    vector<Z<p>> coeffs(d);
+    for (auto & coeff : coeffs) { coeff = Z<p>(static_cast<unsigned>(r % Z<p>::modulus()));  r /= Z<p>::modulus(); }
+    return Polynomial<Z<p>>::fromCoeffVector(coeffs).with_monic(d);
+}
+
+
+// Flat array of bits indexed by rank.
+// The words are either owned or those of a memory mapping, e. g. of a file of the SieveCache, which the bitset keeps alive.
+class RankBitset
+{
+    vector<uint64_t>      storage;
+    std::shared_ptr<void> mapping;
+    uint64_t            * words;
+    uint64_t              bits;
+
+    uint64_t word_count() const { return (bits + 63) / 64; }
+
+public:
+    explicit RankBitset(uint64_t bits = 0) : storage((bits + 63) / 64), words(storage.data()), bits(bits) { }
+
+    // A bitset on the given words of a mapping. Copies of it share the mapping.
+    RankBitset(std::shared_ptr<void> mapping, uint64_t * words, uint64_t bits) : mapping(std::move(mapping)), words(words), bits(bits) { }
+
+    RankBitset(RankBitset const & other)
+        : storage(other.storage), mapping(other.mapping), words(mapping ? other.words : storage.data()), bits(other.bits) { }
+    RankBitset(RankBitset &&) = default;
+
+    RankBitset & operator =(RankBitset const & other) { return *this = RankBitset(other); }
+    RankBitset & operator =(RankBitset &&) = default;
+
+    uint64_t size() const { return bits; }
+
+    // The words of the bitset, bit i is bit i % 64 of word i / 64. The bits above size() are 0 after flip().
+    uint64_t const * data() const { return words; }
+
+    bool test (uint64_t i) const { return words[i / 64] >> (i % 64) & 1u; }
+    void set  (uint64_t i)       { words[i / 64] |= uint64_t(1) << (i % 64); }
+
+    // Like set, but safe for concurrent calls of any threads on the same bitset. Marks are only ever added, so the order does not matter.
+    void set_atomic(uint64_t i) { __atomic_fetch_or(&words[i / 64], uint64_t(1) << (i % 64), __ATOMIC_RELAXED); }
+
+    // Like set_atomic, but returns whether this call set the bit, i. e. it was not set before.
+    bool set_atomic_first(uint64_t i)
+    {
+        uint64_t const bit = uint64_t(1) << (i % 64);
+        return (__atomic_fetch_or(&words[i / 64], bit, __ATOMIC_RELAXED) & bit) == 0;
+    }
+
+    // Clears all bits, so that the bitset can be reused for the next window of ranks.
+    void reset() { std::fill(words, words + word_count(), uint64_t(0)); }
+
+    // Flips all bits, e. g. to turn the marks of reducible polynomials into the marks of irreducible ones.
+    void flip()
+    {
+        for (uint64_t k = 0; k < word_count(); ++k) words[k] = ~words[k];
+        if (bits % 64 != 0) words[word_count() - 1] &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+
+    uint64_t count() const
+    {
+        uint64_t c = 0;
+        for (uint64_t k = 0; k < word_count(); ++k)
+            for (uint64_t w = words[k]; w != 0; w &= w - 1) ++c;
+        return c;
+    }
+
+    // Calls func(i) for every set bit i in ascending order.
+    template <typename Func>
+    void for_each_set(Func && func) const
+    {
+        for (uint64_t k = 0; k < word_count(); ++k)
+            for (uint64_t w = words[k]; w != 0; w &= w - 1)
+                func(64 * k + Utility::top_bit(w & (~w + 1)));
+    }
+};
+
+
+// Throughput counters of a parallel sieve, one entry per degree.
+// The degrees overlap, so the time of a degree is the sum of the time its tasks took on any thread.
+struct SieveStats
+{
+    unsigned         threads = 1;
+    vector<uint64_t> products;   // number of products of irreducible polynomials marked as reducible
+    vector<double>   seconds;    // time of the tasks of the degree, summed over the threads
+    double           wall = 0.0; // wall time of the whole sieve
+
+    explicit SieveStats(unsigned n = 0) : products(n, 0), seconds(n, 0.0) { }
+
+    // Products per second and thread.
+    double throughput(unsigned d) const { return seconds[d] > 0 ? products[d] / seconds[d] : 0.0; }
+
+    // Products per second of all threads together.
+    double total_throughput() const
+    {
+        uint64_t total = 0;
+        for (auto c : products) total += c;
+        return wall > 0 ? total / wall : 0.0;
+    }
+};
+
+
+// Marks the rank of every product of the iteration of iterator_multi_increment_delta over [begs[i], ends[i]) in reducible.
+// Adds the number of products and the time taken to products and nanoseconds. Safe for concurrent calls.
+// If counters is given, they are added to it instead, with the products told apart into first and redundant marks;
+// counters must not be shared then, so the hot loop does not touch the shared atomics at all.
+template <unsigned p, typename Iterator>
+void mark_products(RankBitset              & reducible,
+                   vector<Iterator> const  & begs,
+                   vector<Iterator> const  & ends,
+                   std::atomic<uint64_t>   & products,
+                   std::atomic<uint64_t>   & nanoseconds,
+                   PartitionCounters       * counters = nullptr)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    uint64_t count = 0, first = 0;
+    MultiIncrementProduct<Polynomial<Z<p>>, Iterator> prods(begs, ends, Polynomial<Z<p>>(Z<p>(1)));
+    if (stats_compiled and counters != nullptr)
+        do
+        {
+            first += reducible.set_atomic_first(rank<p>(prods.product()));
+            ++count;
+        }
+        while (prods.next());
+    else
+        do
+        {
+            reducible.set_atomic(rank<p>(prods.product()));
+            ++count;
+        }
+        while (prods.next());
+
+    uint64_t const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (stats_compiled and counters != nullptr)
+    {
+        counters->products    += count;
+        counters->eliminated  += first;
+        counters->redundant   += count - first;
+        counters->nanoseconds += ns;
+        return;
+    }
+    products.fetch_add(count, std::memory_order_relaxed);
+    nanoseconds.fetch_add(ns, std::memory_order_relaxed);
+}
+
+
+// Sieve of the irreducible polynomials of (Z/pZ)[x] with degree < n.
+// Instead of storing every candidate of degree k as a Polynomial object, degree k is a RankBitset of p^k bits.
+// The products of the partitions of k are marked by their rank; the unmarked ranks are the irreducible polynomials.
+// Only the irreducible polynomials of degree < n-1 are kept as Polynomial objects, as they are the factors of higher degrees.
+// The partitions are split into tasks of the thread pool, which mark the shared bitset atomically without any lock.
+// The tasks are scheduled by run_partition_pipeline, so a partition starts as soon as the degrees of its parts are final.
+template <unsigned p>
+class RankSieve
+{
+public:
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+
+    // The largest n such that a RankSieve(n) can index its ranks by uint64_t.
+    static unsigned max_degree()
+    {
+        unsigned n = 1;
+        for (uint64_t c = 1; c <= (uint64_t(1) << 63) / K::modulus(); c *= K::modulus()) ++n;
+        return n;
+    }
+
+    // Estimate of the bytes a RankSieve(n) allocates: the bitsets of all degrees and the kept irreducible polynomials.
+    static uint64_t memory_bytes(unsigned n)
+    {
+        uint64_t bytes = 0, size = 1;
+        for (unsigned k = 0; k < n; ++k, size *= K::modulus())
+        {
+            bytes += (size + 63) / 64 * sizeof(uint64_t);
+            if (k + 1 < n) bytes += (k == 0 ? 1 : size / k) * sizeof(KPoly);
+        }
+        return bytes;
+    }
+
+    explicit RankSieve(unsigned n) : n(n), irreducible(n), factors(n), seeded(n, false), counters(n) { }
+
+    // Sets the irreducible polynomials of degree k < n to the marks of a previous run, e. g. from the SieveCache.
+    // Must be called before run(), which then skips the partitions of k.
+    void seed(unsigned k, RankBitset marks)
+    {
+        irreducible[k] = std::move(marks);
+        seeded[k]      = true;
+    }
+
+    bool is_seeded(unsigned k) const { return seeded[k]; }
+
+    // Lets run() count into counters, which must have n degrees and a slot for every thread of the pool.
+    void count_into(SieveCounters * counters) { partition_counters = counters; }
+
+    void run()
+    {
+        auto const start = std::chrono::steady_clock::now();
+
+        uint64_t size = 1;
+        for (unsigned k = 0; k < n; ++k, size *= K::modulus()) if (not seeded[k]) irreducible[k] = RankBitset(size);
+
+        vector<std::atomic<uint64_t>> products(n), nanoseconds(n);
+        auto & pool = Utility::thread_pool();
+        auto const lock_waits = pool.lock_waits();
+        auto split = [this, &pool, &products, &nanoseconds](unsigned k, size_t i, vector<unsigned> const & dc)
+        {
+            vector<std::function<void()>> tasks;
+            if (seeded[k]) return tasks;
+
+            vector<Iterator> begs, ends;
+            begs.reserve(dc.size());
+            ends.reserve(dc.size());
+            for (unsigned d : dc)
+            {
+                begs.push_back(factors[d].cbegin());
+                ends.push_back(factors[d].cend()  );
+            }
+
+            for (auto & part : Utility::split_multi_increment(begs, ends))
+                tasks.emplace_back([this, k, i, part, &pool, &products, &nanoseconds]
+                {
+                    PartitionCounters * local = partition_counters ? &partition_counters->local(pool.thread_index(), k, i) : nullptr;
+                    mark_products<p>(irreducible[k], part.first, part.second, products[k], nanoseconds[k], local);
+                });
+            return tasks;
+        };
+        auto finalize = [this](unsigned k)
+        {
+            if (not seeded[k]) irreducible[k].flip();
+            if (k + 1 < n) for_each_irreducible(k, [this, k](KPoly const & f) { factors[k].push_back(f); });
+        };
+
+        run_partition_pipeline(pool, n, split, finalize);
+
+        // With --stats the tasks only count into partition_counters, so the figures of -v are taken from there.
+        counters.threads = pool.size();
+        for (unsigned k = 0; k < n; ++k)
+        {
+            bool const counted = stats_compiled and partition_counters != nullptr;
+            PartitionCounters const c = counted ? partition_counters->merged(k) : PartitionCounters();
+            counters.products[k] = counted ? c.products           : products[k].load();
+            counters.seconds[k]  = counted ? c.nanoseconds * 1e-9 : nanoseconds[k].load() * 1e-9;
+        }
+        counters.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (stats_compiled and partition_counters != nullptr)
+        {
+            for (unsigned k = 0; k < n; ++k) partition_counters->set_candidates(k, irreducible[k].size());
+            partition_counters->lock_waits = pool.lock_waits() - lock_waits;
+            partition_counters->wall       = counters.wall;
+        }
+    }
+
+    unsigned degrees() const { return n; }
+
+    SieveStats const & stats() const { return counters; }
+
+    // The irreducible polynomials of degree d as marks by rank.
+    RankBitset const & marks(unsigned d) const { return irreducible[d]; }
+
+    // Number of irreducible polynomials of degree d.
+    uint64_t count(unsigned d) const { return irreducible[d].count(); }
+
+    // Calls func(f) for every irreducible polynomial f of degree d in ascending rank.
+    template <typename Func>
+    void for_each_irreducible(unsigned d, Func && func) const
+    {
+        irreducible[d].for_each_set([&func, d](uint64_t r) { func(unrank<p>(r, d)); });
+    }
+
+    // Returns the irreducible polynomials of degree d.
+    vector<KPoly> irreducibles(unsigned d) const
+    {
+        if (d + 1 < n) return factors[d];
+        vector<KPoly> res;
+        for_each_irreducible(d, [&res](KPoly const & f) { res.push_back(f); });
+        return res;
+    }
+
+private:
+    unsigned           n;
+    vector<RankBitset> irreducible;
+    vector<vector<KPoly>> factors;
+    vector<bool>       seeded;
+    SieveStats         counters;
+    SieveCounters    * partition_counters = nullptr;
+
+    using Iterator = typename vector<KPoly>::const_iterator;
+};
+
+
+// Calculates the irreducible Polynomials of (Z/pZ)[x] with degree up to n with the RankSieve.
+// Return type is vector<vector<KPoly>>.
+template<unsigned p>
+auto getPolynomialsRanked(unsigned n)
+{
+    RankSieve<p> sieve(n);
+    sieve.run();
+
+    vector<vector<Polynomial<Z<p>>>> polys(n);
+    for (unsigned d = 0; d < n; ++d) polys[d] = sieve.irreducibles(d);
+    return polys;
+}
+
+} // namespace Modulus
@@ -0,0 +1,123 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no reduction.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+
+namespace Modulus
+{
+
+// Reduction modulo a fixed polynomial f of degree n by a precomputed inverse (the polynomial analogue of Barrett reduction).
+// With rev_k(a) = x^k a(1/x), the quotient of a of degree < 2n - 1 by f is rev_m(rev(a) rev(f)^-1 mod x^m), m = deg(a) - n + 1.
+// rev(f)^-1 mod x^(n-1) is computed once by Newton iteration, so each reduction costs two multiplications,
+// which use the fast multiplication tiers of Polynomial<Z<p>>.
+// Below newton_threshold() the plain division is faster and used instead.
+template <unsigned p, typename deg_type = size_t>
+class Reducer
+{
+public:
+    using K     = Z<p>;
+    using KPoly = Polynomial<K, deg_type>;
+
+    // The degree of f from which the precomputed inverse is used, see calibrate_reduction in calibrate.hpp.
+    // The lazy division of Polynomial<Z<p>> for p <= 181 is only beaten once the multiplications use the NTT.
+    static size_t & newton_threshold() noexcept
+    {
+        static size_t threshold = Utility::lazy_rows<p>() > 0 ? 16384 : 48;
+        return threshold;
+    }
+
+    // f must not be constant.
+    explicit Reducer(KPoly f) : f(std::move(f)), n(deg(this->f))
+    {
+        if (n < newton_threshold()) return;
+
+        // Newton iteration g <- g (2 - h g) mod x^k doubles the number of correct coefficients of g = h^-1.
+        KPoly const h = reversed(this->f, n + 1);
+        KPoly       g(K(1) / h.at(0));
+        for (size_t k = 1; k < n - 1; )
+        {
+            k = std::min(2 * k, n - 1);
+            g = truncated(g * (KPoly(K(2)) - truncated(truncated(h, k) * g, k)), k);
+        }
+        inv_rev = std::move(g);
+    }
+
+    KPoly const & modulus() const noexcept { return f; }
+
+    // a mod f.
+    KPoly reduce(KPoly const & a) const
+    {
+        if (deg(a) < n or a.is_zero()) return a;
+        if (inv_rev.is_zero() or deg(a) > 2 * n - 2) return a % f;
+
+        size_t const m = deg(a) - n + 1;
+        KPoly const q = reversed(truncated(truncated(reversed(a, deg(a) + 1), m) * truncated(inv_rev, m), m), m);
+        return truncated(a - q * f, n);
+    }
+
+    // a * b mod f for reduced a and b.
+    KPoly mulmod(KPoly const & a, KPoly const & b) const { return reduce(a * b); }
+
+    // base^e mod f by square and multiply.
+    KPoly powmod(KPoly base, std::uint64_t e) const
+    {
+        KPoly result(K(1));
+        base = reduce(base);
+        for (; e != 0; e >>= 1)
+        {
+            if (e & 1u) result = mulmod(result, base);
+            if (e > 1)  base   = mulmod(base,   base);
+        }
+        return reduce(result);
+    }
+
+private:
+    KPoly  f;
+    size_t n;
+    KPoly  inv_rev;  // rev(f)^-1 mod x^(n-1), zero below the threshold
+
+    // a mod x^k.
+    static KPoly truncated(KPoly const & a, size_t k)
+    {
+        if (deg(a) < k) return a;
+        std::vector<K> coeffs(k);
+        for (size_t i = 0; i < k; ++i) coeffs[i] = a.at(i);
+        return KPoly::fromCoeffVector(coeffs);
+    }
+
+    // rev_(len - 1)(a mod x^len), i. e. the coefficients 0 ... len - 1 of a in reverse order.
+    static KPoly reversed(KPoly const & a, size_t len)
+    {
+        std::vector<K> coeffs(len);
+        for (size_t i = 0; i < len; ++i) coeffs[len - 1 - i] = a.at(i);
+        return KPoly::fromCoeffVector(coeffs);
+    }
+};
+
+} // namespace Modulus
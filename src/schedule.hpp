@@ -0,0 +1,97 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no schedule.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <utility>
+
+#include "parallel.hpp"
+#include "partition.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+
+// Runs the jobs of a sieve over the degrees 0 ... n-1 on the pool in dependency order, without a barrier between degrees.
+// A degree is final when all jobs of its partitions have finished; then finalize(k) is called once.
+// The job of a partition dc of k needs exactly the degrees of its parts to be final.
+// As every degree d < k is a part of [d, 1, ..., 1], finalizing k implies that all lower degrees are final,
+// so the job waits for its largest part only. Jobs of higher degrees therefore overlap with the tail of lower ones.
+// split(k, i, dc) is called when the job of dc, the partition i of decomp(k), may start and returns its tasks, vector<std::function<void()>>.
+template <typename Split, typename Finalize>
+void run_partition_pipeline(Utility::ThreadPool & pool, unsigned n, Split && split, Finalize && finalize)
+{
+    struct Degree
+    {
+        vector<vector<unsigned>>           partitions;
+        std::atomic<size_t>                pending { 0 };  // unfinished jobs and tasks
+        vector<std::pair<unsigned, size_t>> waiting;       // jobs (degree, partition index) whose largest part is this degree
+    };
+    vector<Degree> degrees(n);
+    for (unsigned k = 0; k < n; ++k)
+    {
+        degrees[k].partitions = decomp(k);
+        degrees[k].pending    = degrees[k].partitions.size();
+        for (size_t i = 0; i < degrees[k].partitions.size(); ++i)
+            degrees[degrees[k].partitions[i].back()].waiting.emplace_back(k, i);
+    }
+
+    Utility::ThreadPool::TaskGroup group;
+    std::function<void(unsigned)> done;
+
+    // Starts the job of partition i of k, its tasks replace the job in the pending count.
+    auto launch = [&](unsigned k, size_t i)
+    {
+        pool.spawn(group, [&, k, i]
+        {
+            auto tasks = split(k, i, degrees[k].partitions[i]);
+            degrees[k].pending.fetch_add(tasks.size());
+            for (auto & task : tasks)
+                pool.spawn(group, [&done, k, task = std::move(task)] { task();  done(k); });
+            done(k);
+        });
+    };
+
+    done = [&](unsigned k)
+    {
+        if (degrees[k].pending.fetch_sub(1) != 1) return;
+        finalize(k);
+        for (auto const & job : degrees[k].waiting) launch(job.first, job.second);
+    };
+
+    for (unsigned k = 0; k < n; ++k)
+    {
+        if (not degrees[k].partitions.empty()) continue;
+        pool.spawn(group, [&, k]
+        {
+            finalize(k);
+            for (auto const & job : degrees[k].waiting) launch(job.first, job.second);
+        });
+    }
+    pool.wait(group);
+}
+
+} // namespace Modulus
@@ -0,0 +1,183 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "Z.hpp"
+#include "Polynomial.hpp"
+#include "parallel.hpp"
+#include "rank_sieve.hpp"
+
+namespace Modulus
+{
+
+using std::vector;
+using std::uint64_t;
+
+// Sieve of the irreducible polynomials of (Z/pZ)[x] with degree < n in bounded memory.
+// The ranks of degree k are processed in windows of p^(k-t) consecutive ranks, which share their t most significant digits,
+// so only one window of bits is held at a time. For a window the sieve marks every product g * h with an irreducible g of
+// degree d <= k/2 and any monic h of degree k - d which lands in it: the top t coefficients of g * h determine the top
+// coefficients of h by a triangular solve, and only the remaining low coefficients of h are enumerated.
+// As h runs over all monic polynomials instead of products of irreducible ones, the sieve does about ln(k/2) times
+// the work of RankSieve, but it needs only the bits of a window and the irreducible polynomials of degree <= (n-1)/2.
+// The irreducible polynomials of a window are streamed out in ascending rank before the next window starts.
+template <unsigned p>
+class SegmentedSieve
+{
+public:
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+
+    // window_bits is the largest number of ranks held at a time, it is rounded down to a power of p.
+    SegmentedSieve(unsigned n, uint64_t window_bits) : n(n), window_bits(std::max<uint64_t>(window_bits, 64)), counters(n)
+    {
+        RankSieve<p> small(std::max(2u, (n + 1) / 2));
+        small.run();
+        factors.resize(small.degrees());
+        for (unsigned d = 1; d < small.degrees(); ++d) factors[d] = small.irreducibles(d);
+        counters.threads = Utility::thread_pool().size();
+    }
+
+    // Bytes of the window bitset and the kept irreducible polynomials for n and window_bits.
+    static uint64_t memory_bytes(unsigned n, uint64_t window_bits)
+    {
+        return RankSieve<p>::memory_bytes(std::max(2u, (n + 1) / 2)) + (window_bits + 63) / 64 * sizeof(uint64_t);
+    }
+
+    unsigned degrees() const { return n; }
+
+    SieveStats const & stats() const { return counters; }
+
+    // Calls func(f) for every irreducible polynomial f of degree k < n in ascending rank.
+    template <typename Func>
+    void for_each_irreducible(unsigned k, Func && func)
+    {
+        auto const start = std::chrono::steady_clock::now();
+
+        // t is the number of fixed top digits of a window, size = p^(k-t) its number of ranks.
+        unsigned t    = k;
+        uint64_t size = 1;
+        while (t > 0 and size <= window_bits / K::modulus()) { --t;  size *= K::modulus(); }
+
+        uint64_t windows = 1;
+        for (unsigned j = 0; j < t; ++j) windows *= K::modulus();
+
+        RankBitset reducible(size);
+        std::atomic<uint64_t> products { 0 }, nanoseconds { 0 };
+        for (uint64_t w = 0; w < windows; ++w)
+        {
+            reducible.reset();
+            mark_window(k, t, w, reducible, products, nanoseconds);
+            reducible.flip();
+            reducible.for_each_set([&func, k, w, size](uint64_t r) { func(unrank<p>(w * size + r, k)); });
+        }
+
+        counters.products[k] += products.load();
+        counters.seconds[k]  += nanoseconds.load() * 1e-9;
+        counters.wall        += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    unsigned              n;
+    uint64_t              window_bits;
+    vector<vector<KPoly>> factors;   // factors[d] are the irreducible polynomials of degree d <= (n-1)/2
+    SieveStats            counters;
+
+    // Marks the reducible polynomials of degree k whose t top digits are the digits of w in reducible.
+    void mark_window(unsigned k, unsigned t, uint64_t w, RankBitset & reducible,
+                     std::atomic<uint64_t> & products, std::atomic<uint64_t> & nanoseconds) const
+    {
+        uint64_t const size = reducible.size(),
+                       lo   = w * size;
+
+        // top[j] is the coefficient of x^(k-j) of the window, j = 1 ... t.
+        vector<K> top(t + 1, K(1));
+        for (unsigned j = t; j > 0; --j) { top[j] = K(static_cast<unsigned>(w % K::modulus()));  w /= K::modulus(); }
+
+        // Marks the products g * h for the irreducible g of degree d with index in [first, last).
+        auto mark = [this, k, t, lo, size, &top, &reducible, &products, &nanoseconds](unsigned d, size_t first, size_t last)
+        {
+            auto const start = std::chrono::steady_clock::now();
+
+            unsigned const e = k - d,
+                           m = std::min(t, e);
+            uint64_t free = 1;
+            for (unsigned j = m; j < e; ++j) free *= K::modulus();
+
+            uint64_t count = 0;
+            vector<K> h(e + 1);
+            for (size_t i = first; i < last; ++i)
+            {
+                KPoly const & g = factors[d][i];
+
+                // Solves coefficient k-j of g * h for h[e-j], which starts the rank of h at the fixed top digits.
+                h[e] = K(1);
+                uint64_t hlo = 0;
+                for (unsigned j = 1; j <= m; ++j)
+                {
+                    K c = top[j];
+                    for (unsigned l = 1; l <= std::min(j, d); ++l) c -= g.at(d - l) * h[e - j + l];
+                    h[e - j] = c;
+                    hlo = hlo * K::modulus() + static_cast<unsigned>(c);
+                }
+                hlo *= free;
+
+                for (uint64_t r = 0; r < free; ++r)
+                {
+                    uint64_t const fr = rank<p>(g * unrank<p>(hlo + r, e));
+                    // If t > e, h only matched the first e digits of the window.
+                    if (fr - lo < size) reducible.set_atomic(fr - lo);
+                }
+                count += free;
+            }
+
+            products.fetch_add(count, std::memory_order_relaxed);
+            nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(),
+                                  std::memory_order_relaxed);
+        };
+
+        auto & pool = Utility::thread_pool();
+        Utility::ThreadPool::TaskGroup group;
+        for (unsigned d = 1; 2 * d <= k; ++d)
+        {
+            // Combines consecutive g to tasks of about grain products.
+            size_t const grain = 1024;
+            uint64_t free = 1;
+            for (unsigned j = std::min(t, k - d); j < k - d and free < grain; ++j) free *= K::modulus();
+            size_t const chunk = std::max<uint64_t>(1, grain / free);
+            for (size_t i = 0; i < factors[d].size(); i += chunk)
+            {
+                size_t const last = std::min(factors[d].size(), i + chunk);
+                pool.spawn(group, [&mark, d, i, last] { mark(d, i, last); });
+            }
+        }
+        pool.wait(group);
+    }
+};
+
+} // namespace Modulus
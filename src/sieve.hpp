@@ -21,6 +21,8 @@
  */
 
 #include <iostream>
+#include <fstream>
+#include <cstring>
 
 #include <vector>
 #include <list>
@@ -28,12 +30,30 @@
 #include <unordered_map>
 
 #include <functional>
+#include <memory>
 
-#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <new>
+
+#include <unistd.h>
+#include <sys/resource.h>
 
 #include "Z.hpp"
 #include "Polynomial.hpp"
 #include "parallel.hpp"
+#include "partition.hpp"
+#include "rank_sieve.hpp"
+#include "segmented_sieve.hpp"
+#include "cache.hpp"
+#include "output.hpp"
+#include "irreducibility.hpp"
+#include "factor.hpp"
+#include "factor_table.hpp"
+#include "minpoly.hpp"
+#include "options.hpp"
+#include "schedule.hpp"
+#include "counters.hpp"
 
 namespace Modulus
 {
@@ -59,50 +79,12 @@ void ERROR(string msg) { cerr << "Error: " << msg << endl; exit(1); }
 template <typename T, typename... Ts> [[ noreturn ]]
 void ERROR(string msg, T arg, Ts... args)
 {
-    ostringstream os(msg);
+    ostringstream os(msg, std::ios_base::ate);
     os << arg;
     ERROR(os.str(), args...);
 }
 
 
-// Returns the vector of non-trivial additive decompositions of the given number.
-// A positive integer number n can be written as a sum of positive values.
-// Every decomposition is stored as vector of addends.
-// The decomposition of n as just n is the trivial decomposition.
-// The function only returns different decompositions respecting that permutations of addends provide the same decomposition.
-// The only decomposition of zero is the empty vector of addends.
-vector<vector<unsigned>> decomp(unsigned n)
-{
-    // (Haskell with ViewPatterns)
-    // deComp :: Integer -> [[Integer]]
-    // deComp x = d x x where
-    //    d 0  _           = [[]]
-    //    d n (min n -> m) = [ i : dec | i <- [1 .. m], dec <- d (n - i) i ]
-    //
-    using vvu = vector<vector<unsigned>>;
-    std::function<vvu(unsigned, unsigned)> d = 
-        [&d] (unsigned n, unsigned limit)
-        {
-            if (n == 0) return vvu(1);
-
-            vvu result;
-            unsigned m = std::min(n, limit);
-            for (unsigned i = 1; i <= m; ++i)
-            for (auto & dec : d(n - i, i)) // recursion
-            {
-                dec.push_back(i);
-                result.push_back(dec);
-            }
-            return result;
-        };
-
-    auto dec = d(n, n);
-    dec.pop_back(); // the last one is always n itself. We don't need it, and it is IMPORTANT to drop it.
-    return dec;
-}
-
-
-
 // Calculates the irreducible Polynomials of (Z/pZ)[x] with degree up to n.
 // Return type is vector<list<KPoly>>.
 template<unsigned p>
@@ -144,24 +126,18 @@ auto getPolynomials(unsigned n)
         // TODO: Make parallel.
         for (auto const & dc : decomp(k))
         {
-            vector<Iterator> begs, itrs, ends;
+            vector<Iterator> begs, ends;
             begs.reserve(dc.size());
-            itrs.reserve(dc.size());
             ends.reserve(dc.size());
             for (unsigned d : dc)
             {
                 begs.push_back(polys[d].begin());
-                itrs.push_back(polys[d].begin());
                 ends.push_back(polys[d].end()  );
             }
 
-            do
-            {
-                KPoly prod = K(1);
-                for (auto & it : itrs) prod *= *it;
-                polys[k].remove(prod);
-            }
-            while (iterator_multi_increment_delta(itrs, begs, ends));
+            MultiIncrementProduct<KPoly, Iterator> prods(begs, ends, KPoly(K(1)));
+            do polys[k].remove(prods.product());
+            while (prods.next());
         }
     }
 
@@ -169,9 +145,10 @@ auto getPolynomials(unsigned n)
 }
 
 // Calculates the irreducible Polynomials of (Z/pZ)[x] with degree up to n.
-// Return type is vector<list<KPoly>>.
+// If stats is given, it receives the throughput counters of every degree.
+// Return type is vector<unordered_set<KPoly>>.
 template<unsigned p>
-auto getPolynomialsPARALLEL(unsigned n)
+auto getPolynomialsPARALLEL(unsigned n, SieveStats * stats = nullptr)
 {
     using K     = Z<p>;
     using KPoly = Polynomial<K>;
@@ -204,38 +181,71 @@ auto getPolynomialsPARALLEL(unsigned n)
     }
     while (increment(coeffs) != zerocoeffs);
 
-    for (unsigned k = 2; k < n; ++k) // k is the degree of the polynomials we want to eliminate. (remember: max degree == n-1)
+    // Every partition is split into tasks of the persistent thread pool, so partitions of very different cost are balanced.
+    // The tasks mark the ranks of their products atomically in a bitset of their degree, without any lock.
+    // A partition starts as soon as the degrees of its parts are final, so the degrees overlap (see run_partition_pipeline).
+    // When a degree is final, its marked polynomials are erased, so the result is the same as of getPolynomials.
+    auto const start = std::chrono::steady_clock::now();
+
+    vector<RankBitset> reducible(n);
+    uint64_t size = 1;
+    for (unsigned k = 0; k < n; ++k, size *= K::modulus()) reducible[k] = RankBitset(size);
+
+    vector<std::atomic<uint64_t>> products(n), nanoseconds(n);
+    auto split = [&polys, &reducible, &products, &nanoseconds](unsigned k, size_t, vector<unsigned> const & dc)
     {
-        std::mutex polys_mutex;
-        FOR_EACH_PAR (decomp(k), [&polys, &polys_mutex, k](auto & dc)
+        vector<Iterator> begs, ends;
+        for (unsigned d : dc)
         {
-            vector<Iterator> begs, itrs, ends;
-            for (unsigned d : dc)
-            {
-                begs.push_back(polys[d].begin());
-                itrs.push_back(polys[d].begin());
-                ends.push_back(polys[d].end()  );
-            }
+            begs.push_back(polys[d].begin());
+            ends.push_back(polys[d].end()  );
+        }
 
-            do
-            {
-                KPoly prod(1);
-                for (auto & it : itrs) prod *= *it;
-                
-                polys_mutex.lock();
-                {
-                    polys[k].erase(prod);
-                }
-                polys_mutex.unlock();
-            }
-            while (iterator_multi_increment_delta(itrs, begs, ends));
-        });
+        vector<std::function<void()>> tasks;
+        for (auto & part : Utility::split_multi_increment(begs, ends))
+            tasks.emplace_back([&reducible, &products, &nanoseconds, k, part]
+                { mark_products<p>(reducible[k], part.first, part.second, products[k], nanoseconds[k]); });
+        return tasks;
+    };
+    auto finalize = [&polys, &reducible](unsigned k)
+    {
+        for (auto it = polys[k].begin(); it != polys[k].end(); )
+        {
+            if (reducible[k].test(rank<p>(*it))) it = polys[k].erase(it);
+            else                                 ++it;
+        }
+    };
+
+    auto & pool = Utility::thread_pool();
+    run_partition_pipeline(pool, n, split, finalize);
+
+    if (stats != nullptr)
+    {
+        *stats = SieveStats(n);
+        stats->threads = pool.size();
+        for (unsigned k = 0; k < n; ++k)
+        {
+            stats->products[k] = products[k].load();
+            stats->seconds[k]  = nanoseconds[k].load() * 1e-9;
+        }
+        stats->wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
 
     return polys;
 }
 
 
+// Calculates the irreducible Polynomials of (Z/pZ)[x] of exactly degree n, without any polynomial of lower degree.
+// They are the minimal polynomials of the Lyndon word elements of a normal basis of GF(p^n), see minpoly.hpp.
+// Return type is vector<KPoly>.
+template<unsigned p>
+auto getPolynomialsOfDegree(unsigned n)
+{
+    vector<Polynomial<Z<p>>> polys;
+    for_each_irreducible_of_degree<p>(n, [&polys](Polynomial<Z<p>> const & g) { polys.push_back(g); });
+    return polys;
+}
+
 // For given n it returns the unordered_map which any polynomial of (Z/pZ)[x] which is reducible is mapped on the canonical decomposition
 // of irreducible polynomials. The return type is unordered_map<KPoly, vector<KPoly>>, but is unnecessary complex to read since KPoly is defined inside.
 // That means especially that deg(f) <= n implies:
@@ -288,74 +298,329 @@ auto getPolynomialsDecomposition(unsigned n)
     {
         for (auto const & dc : decomp(k))
         {
-            vector<Iterator> begs, itrs, ends;
+            vector<Iterator> begs, ends;
             begs.reserve(dc.size());
-            itrs.reserve(dc.size());
             ends.reserve(dc.size());
             for (unsigned d : dc)
             {
                 begs.push_back(polys[d].begin());
-                itrs.push_back(polys[d].begin());
                 ends.push_back(polys[d].end()  );
             }
 
+            MultiIncrementProduct<KPoly, Iterator> prods(begs, ends, KPoly(K(1)));
             do
             {
-                KPoly prod = K(1);
-                for (auto & it : itrs) prod *= *it;
-                polys[k].remove(prod);
-                result[std::move(prod)] = dereference_vector(itrs); // [[!] added line]
+                polys[k].remove(prods.product());
+                result[prods.product()] = dereference_vector(prods.iterators()); // [[!] added line]
             }
-            while (iterator_multi_increment_delta(itrs, begs, ends));
+            while (prods.next());
         }
     }
     return result; // [[!] polys --> result]
 }
 
 
+// Parallel version of getPolynomialsDecomposition, returning the same map.
+// The factors are taken from a RankSieve, their vectors are in the same order as the lists of getPolynomialsDecomposition.
+// All partitions of all degrees are independent then. They are split into tasks of the thread pool,
+// which insert into the table of their thread without locking. The tables are merged at the end.
+// The program itself does not call it, -t takes the factors from the FactorTable instead.
+// It is kept as the reference and benchmark of the parallel sieve, see testing/sieve.cpp and testing/measure.cpp.
+template<unsigned p>
+auto getPolynomialsDecompositionPARALLEL(unsigned n)
+{
+    using KPoly    = Polynomial<Z<p>>;
+    using Table    = unordered_map<KPoly, vector<KPoly>>;
+    using Iterator = typename vector<KPoly>::const_iterator;
+
+    RankSieve<p> sieve(n);
+    sieve.run();
+    vector<vector<KPoly>> polys(n);
+    for (unsigned d = 0; d + 1 < n; ++d) polys[d] = sieve.irreducibles(d);
+
+    auto & pool = Utility::thread_pool();
+    vector<Table> tables(pool.size());
+    auto insert = [&pool, &tables](vector<Iterator> const & begs, vector<Iterator> const & ends)
+    {
+        Table & table = tables[pool.thread_index()];
+        MultiIncrementProduct<KPoly, Iterator> prods(begs, ends, KPoly(1));
+        do
+        {
+            vector<KPoly> factors;
+            factors.reserve(begs.size());
+            for (auto & it : prods.iterators()) factors.push_back(*it);
+            table.emplace(prods.product(), std::move(factors));
+        }
+        while (prods.next());
+    };
+
+    Utility::ThreadPool::TaskGroup group;
+    for (unsigned k = 2; k < n; ++k)
+    for (auto const & dc : decomp(k))
+    {
+        vector<Iterator> begs, ends;
+        for (unsigned d : dc)
+        {
+            begs.push_back(polys[d].cbegin());
+            ends.push_back(polys[d].cend()  );
+        }
+        Utility::spawn_multi_increment_parts(pool, group, begs, ends, insert);
+    }
+    pool.wait(group);
+
+    // Every reducible polynomial has exactly one factorization, so the tables are disjoint.
+    size_t total = 0;
+    for (auto const & table : tables) total += table.size();
+    Table result(std::move(tables.front()));
+    result.reserve(total);
+    for (size_t i = 1; i < tables.size(); ++i)
+        for (auto & entry : tables[i]) result.emplace(entry.first, std::move(entry.second));
+    return result;
+}
+
+
+// Prints the throughput of every degree of a sieve run.
+void printSieveStats(SieveStats const & stats, std::ostream & out)
+{
+    out << "Sieve with " << stats.threads << " thread(s) in " << stats.wall << " s, "
+        << static_cast<uint64_t>(stats.total_throughput()) << " products/s:" << endl;
+    for (unsigned d = 0; d < stats.products.size(); ++d)
+    {
+        if (stats.products[d] == 0) continue;
+        out << "  degree " << d << ": " << stats.products[d] << " products in " << stats.seconds[d] << " s of the threads, "
+            << static_cast<uint64_t>(stats.throughput(d)) << " products/s per thread" << endl;
+    }
+}
 
+// Writes the irreducible polynomials of the degrees the sieve computed into the cache, skipping the ones it was seeded with.
 template<unsigned p>
-void printPolynomials(unsigned n, std::ostream & out)
+void storeCached(RankSieve<p> const & sieve, SieveCache const & cache)
 {
-    auto polys = getPolynomialsPARALLEL<p>(n + 1);
-    unsigned total_count = 0;
-    for (auto & deg_d_polys : polys) total_count += deg_d_polys.size();
+    for (unsigned d = 0; d < sieve.degrees(); ++d)
+        if (not sieve.is_seeded(d) and not cache.store(Z<p>::modulus(), d, sieve.marks(d)))
+            cerr << "Warning: cannot write the cache file " << cache.file(Z<p>::modulus(), d) << "." << endl;
+}
 
-    out << "Irreducible Polynomials modulo " << p << " of degree up to " << n << " (" << total_count << "):" << endl;
-    for (unsigned d = 0; d < polys.size(); ++d)
+// Prints the counters of --stats on the error stream, or writes them to the JSON file of --stats-json.
+inline void printSieveCounters(SieveCounters const & counters, Options const & opts)
+{
+    if (opts.stats_json.empty())
     {
-        out << "Degree " << d << " (" << polys[d].size() << "):" << endl;
-        for (auto & poly : polys[d]) out << poly << endl;
-        out << endl;
+        counters.print(cerr);
+        return;
     }
+    std::ofstream file(opts.stats_json, std::ofstream::trunc);
+    if (not file.good()) ERROR("stats-json: cannot open/write file.");
+    counters.write_json(file);
+}
+
+// The bytes the process may allocate: the physical memory, or less if limited by ulimit -v.
+inline uint64_t available_memory()
+{
+    long const pages = ::sysconf(_SC_PHYS_PAGES), page = ::sysconf(_SC_PAGE_SIZE);
+    uint64_t bytes = pages > 0 and page > 0 ? uint64_t(pages) * uint64_t(page) : ~uint64_t(0);
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_AS, &limit) == 0 and limit.rlim_cur != RLIM_INFINITY) bytes = std::min<uint64_t>(bytes, limit.rlim_cur);
+    return bytes;
 }
 
+template<unsigned p>
+void printPolynomials(unsigned n, std::ostream & out, Options const & opts)
+{
+    if (n >= RankSieve<p>::max_degree()) ERROR("degree ", n, " is too large for p = ", Z<p>::modulus(), ".");
+
+    PolynomialWriter<p> writer(out, opts.format);
+    auto const write = [&writer](auto const & poly) { writer.poly(poly); };
+
+    if (opts.exact_degree)
+    {
+        writer.begin(n, irreducible_count<p>(n), true);
+        writer.degree(n, irreducible_count<p>(n));
+        for_each_irreducible_of_degree<p>(n, write);
+        writer.end_degree();
+        writer.end();
+        return;
+    }
+
+    std::unique_ptr<SieveCache> cache;
+    if (not opts.cache_dir.empty()) cache.reset(new SieveCache(opts.cache_dir));
+
+    // If the RankSieve exceeds the memory limit, the SegmentedSieve streams the polynomials window by window.
+    // The counts of the header are known beforehand by Gauss' formula then.
+    uint64_t const limit = uint64_t(opts.memory_limit) << 20;
+    if (limit != 0 and RankSieve<p>::memory_bytes(n + 1) > limit)
+    {
+        uint64_t const fixed = SegmentedSieve<p>::memory_bytes(n + 1, 0);
+        if (fixed >= limit) ERROR("memory limit of ", opts.memory_limit, " MiB is too small for degree ", n, ".");
+        SegmentedSieve<p> sieve(n + 1, (limit - fixed) * 8);
+
+        uint64_t total_count = 0;
+        for (unsigned d = 0; d <= n; ++d) total_count += irreducible_count<p>(d);
+
+        writer.begin(n, total_count, false);
+        for (unsigned d = 0; d <= n; ++d)
+        {
+            writer.degree(d, irreducible_count<p>(d));
+            RankBitset marks;
+            if (cache and cache->load(Z<p>::modulus(), d, marks))
+                marks.for_each_set([&writer, d](uint64_t r) { writer.poly(unrank<p>(r, d)); });
+            else
+                sieve.for_each_irreducible(d, write);
+            writer.end_degree();
+        }
+        writer.end();
+
+        if (opts.verbose) printSieveStats(sieve.stats(), cerr);
+        return;
+    }
+
+    // Without a memory limit the RankSieve must fit into the memory at all, otherwise it would fail half way.
+    if (limit == 0 and RankSieve<p>::memory_bytes(n + 1) > available_memory())
+        ERROR("degree ", n, " needs about ", RankSieve<p>::memory_bytes(n + 1) >> 20, " MiB, but only ", available_memory() >> 20,
+              " MiB are available, use --memory-limit.");
+
+    RankSieve<p> sieve(n + 1);
+    if (cache)
+        for (unsigned d = 0; d <= n; ++d)
+        {
+            RankBitset marks;
+            if (cache->load(Z<p>::modulus(), d, marks)) sieve.seed(d, std::move(marks));
+        }
+    std::unique_ptr<SieveCounters> counters;
+    if (opts.stats)
+    {
+        counters.reset(new SieveCounters(n + 1, Utility::thread_pool().size()));
+        sieve.count_into(counters.get());
+    }
+    try { sieve.run(); }
+    catch (std::bad_alloc const &) { ERROR("out of memory for degree ", n, ", use --memory-limit."); }
+    if (counters) printSieveCounters(*counters, opts);
+    if (cache) storeCached(sieve, *cache);
+    uint64_t total_count = 0;
+    for (unsigned d = 0; d <= n; ++d) total_count += sieve.count(d);
+
+    writer.begin(n, total_count, false);
+    for (unsigned d = 0; d <= n; ++d)
+    {
+        writer.degree(d, sieve.count(d));
+        sieve.for_each_irreducible(d, write);
+        writer.end_degree();
+    }
+    writer.end();
+
+    if (opts.verbose) printSieveStats(sieve.stats(), cerr);
+}
 
 template <unsigned p>
-void testPolynomials(char** argv, std::ostream & out)
+void testPolynomials(char** argv, std::ostream & out, Options const & opts)
 {
     using KPoly = Polynomial<Z<p>>;
-    
-    if (*argv == nullptr) return;
+
+    // Inputs are tested in batches, so that an input file of any size is streamed.
+    size_t const batch = size_t(1) << 16;
+
+    std::unique_ptr<SieveCache> cache;
+    if (not opts.cache_dir.empty()) cache.reset(new SieveCache(opts.cache_dir));
+    unordered_map<unsigned, RankBitset> cached;
+    unordered_set<unsigned>             looked_up;
+
+    std::unique_ptr<FactorTable<p>> table;
+    unsigned                        table_degrees = 0;
+
+    auto const start  = std::chrono::steady_clock::now();
+    uint64_t   tested = 0;
+
+    auto test = [&](vector<KPoly> const & inputs)
+    {
+        // Rabin's test answers "irreducible or not" for each input on its own.
+        // Reducible inputs are factored on their own as well, without any table of lower degree polynomials.
+        // Only if there are many inputs compared to the p^d polynomials up to their degree d, a FactorTable pays off.
+        // A table is kept for the following batches.
+        unsigned max_deg = 0;
+        for (auto const & input : inputs) max_deg = std::max<unsigned>(max_deg, deg(input));
+
+        uint64_t table_size = 1;
+        for (unsigned i = 0; i < max_deg and table_size <= 64 * inputs.size(); ++i) table_size *= Z<p>::modulus();
+        if (max_deg >= table_degrees and table_size <= 64 * inputs.size())
+        {
+            table.reset(new FactorTable<p>(max_deg + 1));
+            table_degrees = max_deg + 1;
+        }
+
+        // Degrees of the inputs which are in the cache are answered by the rank of the input.
+        if (cache)
+            for (auto const & input : inputs)
+            {
+                RankBitset marks;
+                if (looked_up.insert(deg(input)).second and cache->load(Z<p>::modulus(), deg(input), marks))
+                    cached.emplace(deg(input), std::move(marks));
+            }
+        auto const in_table = [&table, &table_degrees](KPoly const & f) { return table and deg(f) < table_degrees; };
+        auto const irreducible = [&cached, &table, &in_table](KPoly const & f)
+        {
+            auto const it = cached.find(deg(f));
+            if (it != cached.end()) return it->second.test(rank<p>(monic(f)));
+            return in_table(f) ? table->is_irreducible(f) : is_irreducible(f);
+        };
+
+        auto const result = [&irreducible, &in_table, &table](std::ostream & os, KPoly const & input)
+        {
+            if (deg(input) == 0) { os << input << " is constant."    << '\n';  return; }
+            if (irreducible(input))
+                                 { os << input << " is irreducible." << '\n';  return; }
+
+            auto const fac = in_table(input) ? table->factor(input) : factor(input);
+            os << input << "  =  ";
+            if (fac.unit != Z<p>(1)) os << fac.unit << " * ";
+            os << "(" << contnr_str(fac.factors, ") * (") << ")" << '\n';
+        };
+
+        // The chunks of the batch are tested concurrently, their results are written in input order.
+        auto & pool = Utility::thread_pool();
+        size_t const chunk = std::max<size_t>(64, inputs.size() / (8 * pool.size()) + 1);
+        vector<string> results((inputs.size() + chunk - 1) / chunk);
+        Utility::ThreadPool::TaskGroup group;
+        for (size_t c = 0; c < results.size(); ++c)
+            pool.spawn(group, [&inputs, &results, &result, chunk, c]
+            {
+                ostringstream os;
+                for (size_t i = c * chunk; i < std::min(inputs.size(), (c + 1) * chunk); ++i) result(os, inputs[i]);
+                results[c] = os.str();
+            });
+        pool.wait(group);
+        for (auto const & r : results) out << r;
+        tested += inputs.size();
+    };
 
     vector<KPoly> inputs;
-    unsigned      max_deg = 0;
-    do
+    auto const read = [&inputs](char const * first, char const * last)
     {
-        istringstream iss(*argv);
-        KPoly         inp;
-        if (not(iss >> inp)) ERROR("polynomial '", *argv, "' not well formed.");
-        if (max_deg < deg(inp)) max_deg = deg(inp);
-        inputs.push_back(inp);
+        char const * const token = first;
+        KPoly              inp;
+        if (not KPoly::parse(first, last, inp) or first != last) ERROR("polynomial '", string(token, last), "' not well formed.");
+        inputs.push_back(std::move(inp));
+    };
+
+    for (; *argv != nullptr; ++argv) read(*argv, *argv + std::strlen(*argv));
+    if (not opts.input_file.empty())
+    {
+        bool const opened = Utility::for_each_line(opts.input_file, [&](char const * first, char const * last)
+        {
+            read(first, last);
+            if (inputs.size() < batch) return;
+            test(inputs);
+            inputs.clear();
+        });
+        if (not opened) ERROR("input: cannot open/read file.");
     }
-    while (*(++argv) != nullptr);
+    test(inputs);
+    out.flush();
 
-    auto decompositions = getPolynomialsDecomposition<p>(max_deg + 1);
-    for (auto & input : inputs)
+    if (opts.verbose)
     {
-        auto dec = decompositions.find(input);
-        if (dec == decompositions.end()) out << input << " is irreducible." << endl;
-        else                             out << input << "  =  (" << contnr_str(dec->second, ") * (") << ")" << endl;
+        double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        cerr << "Tested " << tested << " polynomial(s) with " << Utility::thread_pool().size() << " thread(s) in " << seconds << " s, "
+             << static_cast<uint64_t>(seconds > 0 ? tested / seconds : 0.0) << " polynomials/s" << endl;
     }
 }
 
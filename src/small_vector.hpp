@@ -0,0 +1,172 @@
+#pragma once
+
+// Compile with clang++-3.5 -std=c++14
+
+// There is no small_vector.cpp file as it is not needed.
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+#include <type_traits>
+#include <algorithm>
+#include <new>
+
+namespace Modulus { namespace Utility
+{
+
+// A contiguous vector of trivially copyable values which stores up to N values inside the object itself.
+// Only if it grows beyond N values, it allocates memory on the heap.
+template <typename T, size_t N>
+class small_vector
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable.");
+    static_assert(N > 0, "N must be > 0.");
+
+private:
+    T *           ptr;
+    std::uint32_t len;
+    std::uint32_t cap;
+    T             buf[N];
+
+    bool is_inline() const noexcept { return ptr == buf; }
+
+    void grow(size_t new_cap)
+    {
+        if (new_cap <= cap) return;
+        new_cap = std::max<size_t>(new_cap, 2 * static_cast<size_t>(cap));
+        T * mem = static_cast<T *>(std::malloc(new_cap * sizeof(T)));
+        if (mem == nullptr) throw std::bad_alloc();
+        std::memcpy(mem, ptr, len * sizeof(T));
+        if (not is_inline()) std::free(ptr);
+        ptr = mem;
+        cap = static_cast<std::uint32_t>(new_cap);
+    }
+
+public:
+    using value_type     = T;
+    using iterator       = T *;
+    using const_iterator = T const *;
+
+    small_vector() noexcept : ptr(buf), len(0), cap(N) { }
+
+    explicit small_vector(size_t n, T const & value = T()) : small_vector() { resize(n, value); }
+
+    small_vector(small_vector const & other) : small_vector()
+    {
+        grow(other.len);
+        std::memcpy(ptr, other.ptr, other.len * sizeof(T));
+        len = other.len;
+    }
+
+    small_vector(small_vector && other) noexcept : small_vector()
+    {
+        if (other.is_inline()) std::memcpy(buf, other.buf, other.len * sizeof(T));
+        else
+        {
+            ptr = other.ptr;
+            cap = other.cap;
+            other.ptr = other.buf;
+            other.cap = N;
+        }
+        len = other.len;
+        other.len = 0;
+    }
+
+    small_vector & operator =(small_vector const & other)
+    {
+        if (this == &other) return *this;
+        len = 0;
+        grow(other.len);
+        std::memcpy(ptr, other.ptr, other.len * sizeof(T));
+        len = other.len;
+        return *this;
+    }
+
+    small_vector & operator =(small_vector && other) noexcept
+    {
+        if (this == &other) return *this;
+        if (not is_inline()) std::free(ptr);
+        ptr = buf;
+        cap = N;
+        if (other.is_inline()) std::memcpy(buf, other.buf, other.len * sizeof(T));
+        else
+        {
+            ptr = other.ptr;
+            cap = other.cap;
+            other.ptr = other.buf;
+            other.cap = N;
+        }
+        len = other.len;
+        other.len = 0;
+        return *this;
+    }
+
+    ~small_vector() { if (not is_inline()) std::free(ptr); }
+
+    size_t   size()     const noexcept { return len; }
+    size_t   capacity() const noexcept { return cap; }
+    bool     empty()    const noexcept { return len == 0; }
+
+    T *       data()       noexcept { return ptr; }
+    T const * data() const noexcept { return ptr; }
+
+    iterator       begin()       noexcept { return ptr; }
+    iterator       end()         noexcept { return ptr + len; }
+    const_iterator begin() const noexcept { return ptr; }
+    const_iterator end()   const noexcept { return ptr + len; }
+
+    T       & operator [](size_t i)       noexcept { return ptr[i]; }
+    T const & operator [](size_t i) const noexcept { return ptr[i]; }
+
+    T       & back()       noexcept { return ptr[len - 1]; }
+    T const & back() const noexcept { return ptr[len - 1]; }
+
+    void reserve(size_t n) { grow(n); }
+    void clear() noexcept  { len = 0; }
+
+    void resize(size_t n, T const & value = T())
+    {
+        grow(n);
+        for (size_t i = len; i < n; ++i) ptr[i] = value;
+        len = static_cast<std::uint32_t>(n);
+    }
+
+    void push_back(T const & value)
+    {
+        if (len == cap) grow(len + 1);
+        ptr[len++] = value;
+    }
+
+    void pop_back() noexcept { --len; }
+
+    friend bool operator ==(small_vector const & v, small_vector const & w)
+    {
+        return v.len == w.len and std::equal(v.begin(), v.end(), w.begin());
+    }
+    friend bool operator !=(small_vector const & v, small_vector const & w) { return not (v == w); }
+    friend bool operator < (small_vector const & v, small_vector const & w)
+    {
+        return std::lexicographical_compare(v.begin(), v.end(), w.begin(), w.end());
+    }
+};
+
+}} // namespace Modulus::Utility
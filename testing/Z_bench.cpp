@@ -0,0 +1,152 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -o "../bin/Z_bench" Z_bench.cpp
+// and with clang++-3.5 -std=c++14 -O2 -DMODULUS_NO_TABLES -o "../bin/Z_bench_no_tables" Z_bench.cpp to compare.
+
+/* This file is part of Modulus.
+ * 
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file is a microbenchmark for the compile time tables of the standalone header "/src/Z.hpp".
+// It measures the inverse, divmod through gcd, and the product loop of the sieve.
+// Additionally it compares multiplication by discrete logarithm tables with the reduction modulo the constant p,
+// which is why Z<p> does not use logarithm tables.
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "../src/Z.hpp"
+#include "../src/Polynomial.hpp"
+#include "../src/irreducibility.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+template <typename F>
+double nanoseconds_per(size_t ops, F && func)
+{
+    auto const start = chrono::steady_clock::now();
+    func();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+// Discrete logarithm tables for p prime, only to compare with.
+template <unsigned p>
+struct LogTables
+{
+    unsigned char log[p] = { }, exp[2 * p] = { };
+
+    constexpr LogTables()
+    {
+        unsigned g = 2;
+        for (; g < p; ++g)
+        {
+            unsigned order = 1;
+            for (unsigned x = g; x != 1; x = x * g % p) ++order;
+            if (order == p - 1) break;
+        }
+        unsigned x = 1;
+        for (unsigned i = 0; i < p - 1; ++i)
+        {
+            exp[i] = exp[i + p - 1] = static_cast<unsigned char>(x);
+            log[x] = static_cast<unsigned char>(i);
+            x = x * g % p;
+        }
+    }
+};
+
+template <unsigned p>
+void bench()
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+
+    mt19937 rng(p);
+    auto random_poly = [&rng](unsigned d)
+    {
+        vector<K> coeffs(d + 1);
+        for (auto & c : coeffs) c = K(static_cast<unsigned>(rng() % p));
+        coeffs.back() = K(1);
+        return KPoly::fromCoeffVector(coeffs);
+    };
+
+    // inverse
+    unsigned volatile sink = 0;
+    size_t const n_inv = 1000000;
+    double const t_inv = nanoseconds_per(n_inv, [&sink]
+        {
+            for (size_t i = 0; i < n_inv; ++i) sink = sink + static_cast<unsigned>(inv(K(static_cast<unsigned>(1 + i % (p - 1)))));
+        });
+
+    // divmod, through the gcd of random polynomials of degree 40
+    vector<KPoly> as, bs;
+    for (int i = 0; i < 200; ++i) { as.push_back(random_poly(40));  bs.push_back(random_poly(39)); }
+    size_t const n_gcd = 20 * as.size();
+    double const t_gcd = nanoseconds_per(n_gcd, [&]
+        {
+            for (int rep = 0; rep < 20; ++rep)
+                for (size_t i = 0; i < as.size(); ++i) sink = sink + deg(gcd(as[i], bs[i]));
+        });
+
+    // product loop of the sieve: products of polynomials of degree 5 and 6
+    vector<KPoly> fs, gs;
+    for (int i = 0; i < 100; ++i) { fs.push_back(random_poly(5));  gs.push_back(random_poly(6)); }
+    size_t const n_prod = fs.size() * gs.size() * 20;
+    double const t_prod = nanoseconds_per(n_prod, [&]
+        {
+            for (int rep = 0; rep < 20; ++rep)
+                for (auto const & f : fs) for (auto const & g : gs) sink = sink + deg(f * g);
+        });
+
+    // coefficient multiplication: modulo the constant p versus discrete logarithm tables
+    static constexpr LogTables<p> tables { };
+    vector<unsigned char> xs(1 << 12), ys(1 << 12), rs(1 << 12);
+    for (auto & x : xs) x = static_cast<unsigned char>(rng() % p);
+    for (auto & y : ys) y = static_cast<unsigned char>(rng() % p);
+    size_t const n_mul = 1000 * xs.size();
+    double const t_mod = nanoseconds_per(n_mul, [&]
+        {
+            for (int rep = 0; rep < 1000; ++rep)
+                for (size_t i = 0; i < xs.size(); ++i) rs[i] = static_cast<unsigned char>((rs[i] + xs[i] * ys[i] % p) % p);
+        });
+    double const t_log = nanoseconds_per(n_mul, [&]
+        {
+            for (int rep = 0; rep < 1000; ++rep)
+                for (size_t i = 0; i < xs.size(); ++i)
+                {
+                    unsigned const m = xs[i] == 0 or ys[i] == 0 ? 0 : tables.exp[tables.log[xs[i]] + tables.log[ys[i]]];
+                    rs[i] = static_cast<unsigned char>((rs[i] + m) % p);
+                }
+        });
+    sink = sink + rs[0];
+
+    cout << "p = " << setw(3) << p << fixed << setprecision(2)
+         << ":  inv " << setw(6) << t_inv << " ns,  gcd " << setw(9) << t_gcd << " ns,  product " << setw(7) << t_prod << " ns,"
+         << "  coeff mul mod p " << t_mod << " ns, by log tables " << t_log << " ns" << endl;
+}
+
+int main()
+{
+    cout << (InverseTable<7>::enabled ? "With" : "Without") << " inverse tables" << endl;
+    bench<  3>();
+    bench<  7>();
+    bench< 19>();
+    bench<101>();
+    bench<251>();
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -o "../bin/calibrate" calibrate.cpp
+
+/* This file is part of Modulus.
+ * 
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file calibrates the multiplication tiers of "/src/calibrate.hpp" and checks them against schoolbook multiplication.
+// The printed thresholds are the candidates for the defaults in "/src/Polynomial.hpp" and "/src/clmul.hpp".
+
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "../src/calibrate.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+string str(size_t n) { return n == numeric_limits<size_t>::max() ? string("never") : to_string(n); }
+
+// Compares the products of all tiers at sizes around the thresholds.
+template <unsigned p>
+bool check(MulThresholds t)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+    size_t const never = numeric_limits<size_t>::max();
+
+    mt19937 rng(p);
+    for (size_t n : { size_t(3), size_t(17), size_t(100), size_t(333) })
+    {
+        vector<K> fc(n + rng() % n), gc(n);
+        for (auto & c : fc) c = K(static_cast<unsigned>(rng() % K::modulus()));
+        for (auto & c : gc) c = K(static_cast<unsigned>(rng() % K::modulus()));
+        KPoly const f = KPoly::fromCoeffVector(fc), g = KPoly::fromCoeffVector(gc);
+
+        mul_thresholds<p>() = { never, never, never };  KPoly const school    = f * g;
+        mul_thresholds<p>() = { 4,     never, never };  KPoly const karatsuba = f * g;
+        mul_thresholds<p>() = { never, 2,     never };  KPoly const kronecker = f * g;
+        mul_thresholds<p>() = { never, never, 2     };  KPoly const ntt       = f * g;
+        if (school != karatsuba or school != ntt or (Utility::kronecker_bits(K::modulus(), n) <= 64 and school != kronecker)) return false;
+    }
+    mul_thresholds<p>() = t;
+    return true;
+}
+
+template <unsigned p>
+void run()
+{
+    MulThresholds const t = calibrate_multiplication<p>();
+    cout << "p = " << Z<p>::modulus() << ":\tkaratsuba " << str(t.karatsuba) << ",\tkronecker " << str(t.kronecker) << ",\tntt " << str(t.ntt)
+         << ",\tnewton " << str(calibrate_reduction<p>())
+         << (check<p>(t) ? "" : "\tWRONG PRODUCTS") << endl;
+}
+
+int main()
+{
+    cout << "GF(2) in words:\tkaratsuba " << str(calibrate_clmul()) << endl;
+    cout << "integers in words:\tkaratsuba " << str(calibrate_bigmul()) << endl;
+    run<3>();
+    run<5>();
+    run<7>();
+    run<13>();
+    run<19>();
+    Z<0>::set_modulus(251);         run<0>();
+    Z<0>::set_modulus(65521);       run<0>();
+    Z<0>::set_modulus(2147483647);  run<0>();
+    return 0;
+}
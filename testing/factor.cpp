@@ -0,0 +1,89 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -o "../bin/factor" factor.cpp
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file tests the factorization of "/src/factor.hpp".
+// Products of known irreducible polynomials, with repeated factors and a unit, must be factored back into them.
+// p = 2 uses the GF(2) words, p = 7 Berlekamp's algorithm and p = 37 Cantor-Zassenhaus.
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/factor.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+template <unsigned p>
+Polynomial<Z<p>> random_irreducible(mt19937 & rng, unsigned d)
+{
+    vector<Z<p>> coeffs(d + 1);
+    do
+    {
+        for (auto & c : coeffs) c = Z<p>(static_cast<unsigned>(rng() % p));
+        coeffs.back() = Z<p>(1);
+    }
+    while (not is_irreducible(Polynomial<Z<p>>::fromCoeffVector(coeffs)));
+    return Polynomial<Z<p>>::fromCoeffVector(coeffs);
+}
+
+// Multiplies random irreducibles of degrees up to max_deg, some of them several times, and factors the product.
+template <unsigned p>
+bool check(unsigned runs, unsigned max_deg)
+{
+    using KPoly = Polynomial<Z<p>>;
+
+    mt19937 rng(p);
+    for (unsigned run = 0; run < runs; ++run)
+    {
+        Z<p> const unit(static_cast<unsigned>(1 + rng() % (p - 1)));
+        KPoly      f(unit);
+        vector<KPoly> expected;
+        for (unsigned i = 0, count = 1 + rng() % 5; i < count; ++i)
+        {
+            KPoly const g = random_irreducible<p>(rng, 1 + rng() % max_deg);
+            // Multiplicities of p and above exercise the p-th roots of the square-free factorization.
+            unsigned const m = rng() % 4 == 0 ? p + rng() % 2 : 1 + rng() % 3;
+            for (unsigned j = 0; j < m and deg(f) < 200; ++j)
+            {
+                f *= g;
+                expected.push_back(g);
+            }
+        }
+        sort_factors(expected);
+
+        auto const fac = factor(f);
+        if (fac.unit != unit or fac.factors != expected)
+        {
+            cout << "p = " << p << ": wrong factorization of " << f << endl;
+            return false;
+        }
+    }
+    cout << "p = " << p << ": " << runs << " products factored." << endl;
+    return true;
+}
+
+int main()
+{
+    bool ok = check<2>(200, 16);
+    ok = check<7>(200, 8) and ok;
+    ok = check<37>(100, 6) and ok;
+    return ok ? 0 : 1;
+}
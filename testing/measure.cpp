@@ -0,0 +1,190 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -pthread -o "../bin/measure" measure.cpp
+
+/* This file is part of Modulus.
+ * 
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file is the microbenchmark suite built on "/src/measure.hpp".
+// It covers the arithmetic of Z<p>, multiplication, divmod and hashing of polynomials, decomp, iterator_multi_increment_delta
+// and every getPolynomials variant across p and n. Each benchmark is repeated, the table shows min, median and standard deviation.
+// Usage: measure [runs=15] [file.json]; the JSON file holds the full statistics to compare a change against a baseline.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <random>
+#include <vector>
+
+#include "../src/measure.hpp"
+#include "../src/sieve.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+using report_t = benchmark_report<chrono::microseconds>;
+
+unsigned volatile sink = 0;
+
+template <unsigned p>
+Polynomial<Z<p>> random_poly(mt19937 & rng, unsigned d)
+{
+    vector<Z<p>> coeffs(d + 1);
+    for (auto & c : coeffs) c = Z<p>(static_cast<unsigned>(rng() % Z<p>::modulus()));
+    coeffs.back() = Z<p>(1);
+    return Polynomial<Z<p>>::fromCoeffVector(coeffs);
+}
+
+template <unsigned p>
+string name(string const & what, unsigned n = 0)
+{
+    ostringstream os;
+    os << what << " p=" << Z<p>::modulus();
+    if (n != 0) os << " n=" << n;
+    return os.str();
+}
+
+// Arithmetic of Z<p> on 2^16 random elements.
+template <unsigned p>
+void bench_Z(report_t & report, size_t runs)
+{
+    using K = Z<p>;
+    mt19937 rng(p);
+    vector<K> xs(1 << 16), ys(1 << 16);
+    for (auto & x : xs) x = K(static_cast<unsigned>(1 + rng() % (K::modulus() - 1)));
+    for (auto & y : ys) y = K(static_cast<unsigned>(1 + rng() % (K::modulus() - 1)));
+
+    report.run(name<p>("Z add+mul 2^16"), runs, 1, [&xs, &ys]
+        {
+            K acc(0);
+            for (size_t i = 0; i < xs.size(); ++i) acc += xs[i] * ys[i];
+            sink = sink + static_cast<unsigned>(acc);
+        });
+    report.run(name<p>("Z division 2^16"), runs, 1, [&xs, &ys]
+        {
+            K acc(0);
+            for (size_t i = 0; i < xs.size(); ++i) acc += xs[i] / ys[i];
+            sink = sink + static_cast<unsigned>(acc);
+        });
+}
+
+// Multiplication, divmod and hashing of random polynomials of degree n.
+template <unsigned p>
+void bench_Polynomial(report_t & report, size_t runs, unsigned n, size_t count)
+{
+    using KPoly = Polynomial<Z<p>>;
+    mt19937 rng(p + n);
+    vector<KPoly> as, bs;
+    for (size_t i = 0; i < count; ++i) { as.push_back(random_poly<p>(rng, n));  bs.push_back(random_poly<p>(rng, n / 2 + 1)); }
+
+    report.run(name<p>("multiply x" + to_string(count), n), runs, 1, [&as]
+        {
+            for (size_t i = 0; i + 1 < as.size(); ++i) sink = sink + deg(as[i] * as[i + 1]);
+        });
+    report.run(name<p>("divmod x" + to_string(count), n), runs, 1, [&as, &bs]
+        {
+            for (size_t i = 0; i < as.size(); ++i) sink = sink + deg(as[i] % bs[i]);
+        });
+    report.run(name<p>("hash x" + to_string(count), n), runs, 1, [&as]
+        {
+            std::hash<KPoly> h;
+            for (auto const & a : as) sink = sink + static_cast<unsigned>(h(a));
+        });
+}
+
+// decomp and the iteration of iterator_multi_increment_delta over the partitions of n into parts of lists of 4.
+void bench_container(report_t & report, size_t runs, unsigned n)
+{
+    report.run("decomp n=" + to_string(n), runs, 1, [n]
+        {
+            for (unsigned k = 0; k <= n; ++k) sink = sink + decomp(k).size();
+        });
+
+    vector<vector<unsigned>> lists(n + 1);
+    for (unsigned d = 1; d <= n; ++d) lists[d].assign(4, d);
+    report.run("iterator_multi_increment_delta n=" + to_string(n), runs, 1, [n, &lists]
+        {
+            using Iterator = vector<unsigned>::const_iterator;
+            for (auto const & dc : decomp(n))
+            {
+                vector<Iterator> begs, ends;
+                for (unsigned d : dc) { begs.push_back(lists[d].cbegin());  ends.push_back(lists[d].cend()); }
+                vector<Iterator> itrs = begs;
+                size_t steps = 0;
+                while (iterator_multi_increment_delta(itrs, begs, ends)) ++steps;
+                sink = sink + steps;
+            }
+        });
+}
+
+// Every getPolynomials variant for degrees < n, and up to n for the ones of exactly degree n.
+template <unsigned p>
+void bench_sieve(report_t & report, size_t runs, unsigned n)
+{
+    report.run(name<p>("getPolynomials", n), runs, 0,
+               [n] { sink = sink + getPolynomials<p>(n).back().size(); });
+    report.run(name<p>("getPolynomialsPARALLEL", n), runs, 0,
+               [n] { sink = sink + getPolynomialsPARALLEL<p>(n).back().size(); });
+    report.run(name<p>("getPolynomialsRanked", n), runs, 0,
+               [n] { sink = sink + getPolynomialsRanked<p>(n).back().size(); });
+    report.run(name<p>("getPolynomialsOfDegree", n - 1), runs, 0,
+               [n] { sink = sink + getPolynomialsOfDegree<p>(n - 1).size(); });
+    report.run(name<p>("getPolynomialsDecomposition", n), runs, 0,
+               [n] { sink = sink + getPolynomialsDecomposition<p>(n).size(); });
+    report.run(name<p>("getPolynomialsDecompositionPARALLEL", n), runs, 0,
+               [n] { sink = sink + getPolynomialsDecompositionPARALLEL<p>(n).size(); });
+}
+
+int main(int argc, char ** argv)
+{
+    size_t runs = 15;
+    if (argc > 1 and not (istringstream(argv[1]) >> runs)) { cerr << "Usage: measure [runs] [file.json]" << endl;  return 1; }
+
+    report_t report;
+
+    bench_Z<  2>(report, runs);
+    bench_Z<  7>(report, runs);
+    bench_Z<251>(report, runs);
+    Z<0>::set_modulus(65521);
+    bench_Z<  0>(report, runs);
+
+    for (unsigned n : { 16u, 64u, 512u, 4096u })
+    {
+        size_t const count = n <= 64 ? 1000 : 64;
+        bench_Polynomial< 2>(report, runs, n, count);
+        bench_Polynomial< 7>(report, runs, n, count);
+        bench_Polynomial< 0>(report, runs, n, count);
+    }
+
+    bench_container(report, runs, 12);
+    bench_container(report, runs, 16);
+
+    bench_sieve< 2>(report, runs, 10);
+    bench_sieve< 2>(report, runs, 13);
+    bench_sieve< 3>(report, runs,  8);
+    bench_sieve< 5>(report, runs,  6);
+    bench_sieve<13>(report, runs,  4);
+
+    report.print(cout);
+    if (argc > 2)
+    {
+        ofstream file(argv[2], ofstream::trunc);
+        report.write_json(file);
+        if (not file.good()) { cerr << "Cannot write " << argv[2] << "." << endl;  return 1; }
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -o "../bin/ntt" ntt.cpp
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file tests the NTT multiplication of "/src/ntt.hpp" and the tiers below it against schoolbook multiplication:
+// the SIMD kernels of "/src/kernels.hpp", Karatsuba, and Kronecker substitution with the integer Karatsuba of "/src/bigint.hpp".
+// Every tier is forced by its threshold on random operands of sizes across the thresholds, balanced and unbalanced.
+
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../src/Polynomial.hpp"
+#include "../src/kernels.hpp"
+#include "../src/bigint.hpp"
+#include "../src/clmul.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+size_t const never = numeric_limits<size_t>::max();
+
+// 1 ... 40, the powers of two with their neighbours up to 1025, and some random sizes up to 3000.
+vector<size_t> test_sizes(mt19937 & rng)
+{
+    vector<size_t> sizes;
+    for (size_t n = 1; n <= 40; ++n) sizes.push_back(n);
+    for (size_t n = 64; n <= 1024; n *= 2) sizes.insert(sizes.end(), { n - 1, n, n + 1 });
+    for (int i = 0; i < 4; ++i) sizes.push_back(1 + rng() % 3000);
+    return sizes;
+}
+
+// Compares the products of all tiers with the schoolbook product in Z<p> arithmetic.
+template <unsigned p>
+bool check()
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+
+    mt19937 rng(K::modulus());
+    auto random_coeffs = [&rng](size_t n)
+    {
+        vector<K> coeffs(n);
+        for (auto & c : coeffs) c = K(static_cast<unsigned>(rng() % K::modulus()));
+        coeffs.back() = K(static_cast<unsigned>(1 + rng() % (K::modulus() - 1)));
+        return coeffs;
+    };
+
+    MulThresholds const thresholds = mul_thresholds<p>();
+    size_t const        bigmul     = Utility::bigmul_karatsuba_threshold();
+    bool ok = true;
+    for (size_t nb : test_sizes(rng))
+    for (size_t na : { nb, nb + rng() % (2 * nb) })
+    {
+        vector<K> const ac = random_coeffs(na), bc = random_coeffs(nb);
+        vector<K>       rc(na + nb - 1);
+        for (size_t i = 0; i < na; ++i)
+            for (size_t j = 0; j < nb; ++j) rc[i + j] += ac[i] * bc[j];
+        KPoly const a = KPoly::fromCoeffVector(ac), b = KPoly::fromCoeffVector(bc), expected = KPoly::fromCoeffVector(rc);
+
+        auto product = [&a, &b](MulThresholds t, size_t big = never)
+        {
+            mul_thresholds<p>() = t;
+            Utility::bigmul_karatsuba_threshold() = big;
+            return a * b;
+        };
+        char const * wrong = nullptr;
+        if      (product({ never, never, never }) != expected) wrong = "schoolbook";
+        else if (product({ 2,     never, never }) != expected) wrong = "karatsuba";
+        else if (product({ never, 1,     never }) != expected) wrong = "kronecker";
+        else if (product({ never, 1,     never }, 4) != expected) wrong = "kronecker with integer karatsuba";
+        else if (product({ never, never, 1     }) != expected) wrong = "ntt";
+        if (wrong != nullptr)
+        {
+            cout << "p = " << K::modulus() << ": " << wrong << " product of sizes " << na << ", " << nb << " is WRONG" << endl;
+            ok = false;
+        }
+    }
+    mul_thresholds<p>() = thresholds;
+    Utility::bigmul_karatsuba_threshold() = bigmul;
+    if (ok) cout << "p = " << K::modulus() << ": all tiers agree with schoolbook." << endl;
+    return ok;
+}
+
+// Compares the dispatched and the vectorized kernels with the portable one; the 16-bit accumulators wrap alike.
+bool check_kernels()
+{
+    mt19937 rng(1);
+    for (size_t nb : test_sizes(rng))
+    {
+        size_t const na = 1 + rng() % 64;
+        vector<uint8_t> a(na), b(nb);
+        for (auto & c : a) c = static_cast<uint8_t>(rng());
+        for (auto & c : b) c = static_cast<uint8_t>(rng());
+
+        vector<uint16_t> expected(na + nb), acc(na + nb);
+        Utility::mul_add_portable(expected.data(), a.data(), na, b.data(), nb);
+        Utility::mul_add(acc.data(), a.data(), na, b.data(), nb);
+        bool same = acc == expected;
+#ifdef MODULUS_X86_TARGETS
+        fill(acc.begin(), acc.end(), 0);
+        Utility::mul_add_sse2(acc.data(), a.data(), na, b.data(), nb);
+        same = same and acc == expected;
+        if (Utility::cpu_has_avx2())
+        {
+            fill(acc.begin(), acc.end(), 0);
+            Utility::mul_add_avx2(acc.data(), a.data(), na, b.data(), nb);
+            same = same and acc == expected;
+        }
+#endif
+        if (not same)
+        {
+            cout << "kernels: mul_add of sizes " << na << ", " << nb << " is WRONG" << endl;
+            return false;
+        }
+    }
+    cout << "kernels: all agree with the portable one." << endl;
+    return true;
+}
+
+// Compares the Karatsuba multiplication of GF(2) words with the schoolbook one.
+bool check_clmul()
+{
+    using KPoly = Polynomial<Z<2>>;
+
+    mt19937 rng(2);
+    size_t const threshold = Utility::clmul_karatsuba_threshold();
+    bool ok = true;
+    for (size_t n : test_sizes(rng))
+    {
+        vector<Z<2>> ac(64 * n + rng() % 64), bc(64 * n / 2 + 1 + rng() % 64);
+        for (auto & c : ac) c = Z<2>(static_cast<unsigned>(rng() % 2));
+        for (auto & c : bc) c = Z<2>(static_cast<unsigned>(rng() % 2));
+        KPoly const a = KPoly::fromCoeffVector(ac), b = KPoly::fromCoeffVector(bc);
+
+        Utility::clmul_karatsuba_threshold() = never;
+        KPoly const expected = a * b;
+        Utility::clmul_karatsuba_threshold() = 2;
+        if (a * b != expected or b * a != expected)
+        {
+            cout << "p = 2: karatsuba product of " << n << " words is WRONG" << endl;
+            ok = false;
+        }
+    }
+    Utility::clmul_karatsuba_threshold() = threshold;
+    if (ok) cout << "p = 2: karatsuba agrees with schoolbook." << endl;
+    return ok;
+}
+
+int main()
+{
+    bool ok = check_kernels();
+    ok = check_clmul() and ok;
+    ok = check<3>()  and ok;
+    ok = check<7>()  and ok;
+    ok = check<13>() and ok;
+    ok = check<19>() and ok;
+    for (unsigned q : { 251u, 65521u, 2147483647u })
+    {
+        Z<0>::set_modulus(q);
+        ok = check<0>() and ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -pthread -o "../bin/parse" parse.cpp
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file tests the polynomial parser and the line reader of "/src/parse.hpp".
+// Malformed polynomials must be rejected, the accepted ones must have the right value,
+// and the polynomials listed by -l must read back through -i unchanged.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "../src/sieve.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+// Parses all of s like -t and -i do; false if it is not well formed or not consumed completely.
+template <unsigned p>
+bool parses(string const & s, Polynomial<Z<p>> & f)
+{
+    char const * first = s.data();
+    return Polynomial<Z<p>>::parse(first, s.data() + s.size(), f) and first == s.data() + s.size();
+}
+
+template <unsigned p>
+bool check_cases()
+{
+    using KPoly = Polynomial<Z<p>>;
+    constexpr auto X = KPoly::X;
+    KPoly const one(Z<p>(1));
+
+    bool ok = true;
+    for (string const s : { "", "x^16777216", "x^4294967298", "x^99999999999999999999", "2x^2 - - 1", "1+", "x^2 +", "+",
+                            "x ^2", "x^ 2", "x^2+1abc", "x^2+1 x", " x", "x ", "x^", "^2", "x^-1", "2 x" })
+    {
+        KPoly f;
+        if (parses<p>(s, f))
+        {
+            cout << "p = " << p << ": '" << s << "' is ACCEPTED" << endl;
+            ok = false;
+        }
+    }
+
+    vector<pair<string, KPoly>> const accepted =
+    {
+        { "x^2 + 1",          (X^2) + one                },
+        { "x^2+1",            (X^2) + one                },
+        { "x^2 +1",           (X^2) + one                },
+        { "x^2+ 1",           (X^2) + one                },
+        { "x^2  -\t1",        (X^2) - one                },
+        { "-x^2 + x",         KPoly() - (X^2) + X        },
+        { "- 1",              KPoly() - one              },
+        { "x^0",              one                        },
+        { "x^2+x^2",          (X^2) + (X^2)              },
+        { "x^16777215",       X^16777215                 },
+        { "x^3+x^1+x^3",      (X^3) + X + (X^3)          },
+    };
+    for (auto const & c : accepted)
+    {
+        KPoly f;
+        if (not parses<p>(c.first, f) or f != c.second)
+        {
+            cout << "p = " << p << ": '" << c.first << "' is " << (parses<p>(c.first, f) ? "read WRONG" : "REJECTED") << endl;
+            ok = false;
+        }
+    }
+    if (ok) cout << "p = " << p << ": malformed polynomials rejected, well formed ones read." << endl;
+    return ok;
+}
+
+// Lists the polynomials up to degree n like -l into a file and reads them back like -i.
+template <unsigned p>
+bool check_round_trip(unsigned n)
+{
+    using KPoly = Polynomial<Z<p>>;
+
+    string const name = "parse_test_p" + to_string(p) + ".txt";
+    {
+        ofstream out(name, ofstream::trunc);
+        printPolynomials<p>(n, out, Options());
+    }
+
+    vector<KPoly> expected;
+    RankSieve<p> sieve(n + 1);
+    sieve.run();
+    for (unsigned d = 0; d <= n; ++d) sieve.for_each_irreducible(d, [&expected](KPoly const & f) { expected.push_back(f); });
+
+    vector<KPoly> read;
+    bool same = true;
+    bool const opened = Utility::for_each_line(name, [&read, &same](char const * first, char const * last)
+    {
+        string const line(first, last);
+        if (line.compare(0, 11, "Irreducible") == 0 or line.compare(0, 6, "Degree") == 0) return;
+        KPoly f;
+        ostringstream os;
+        same = same and parses<p>(line, f) and (os << f, os.str() == line);
+        read.push_back(f);
+    });
+    std::remove(name.c_str());
+
+    if (not opened or not same or read != expected)
+    {
+        cout << "p = " << p << ": the polynomials listed by -l do NOT read back." << endl;
+        return false;
+    }
+    cout << "p = " << p << ": " << read.size() << " polynomials listed by -l read back unchanged." << endl;
+    return true;
+}
+
+int main()
+{
+    bool ok = check_cases<2>();
+    ok = check_cases<3>() and ok;
+    ok = check_cases<7>() and ok;
+    ok = check_round_trip<2>(12) and ok;
+    ok = check_round_trip<3>(7)  and ok;
+    ok = check_round_trip<7>(4)  and ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -o "../bin/reduction" reduction.cpp
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file tests the Reducer of "/src/reduction.hpp".
+// The threshold is lowered so that the Newton inverse is used for every degree; reduce and powmod must agree
+// with the division by % and with powmod of "/src/irreducibility.hpp" on random inputs.
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/reduction.hpp"
+#include "../src/irreducibility.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+template <unsigned p>
+bool check(unsigned max_deg)
+{
+    using K     = Z<p>;
+    using KPoly = Polynomial<K>;
+
+    mt19937 rng(K::modulus());
+    // Random polynomial of degree d, not necessarily monic.
+    auto random_poly = [&rng](size_t d)
+    {
+        vector<K> coeffs(d + 1);
+        for (auto & c : coeffs) c = K(static_cast<unsigned>(rng() % K::modulus()));
+        coeffs.back() = K(static_cast<unsigned>(1 + rng() % (K::modulus() - 1)));
+        return KPoly::fromCoeffVector(coeffs);
+    };
+
+    size_t const threshold = Reducer<p>::newton_threshold();
+    Reducer<p>::newton_threshold() = 1;
+    bool ok = true;
+    for (size_t n = 1; n <= max_deg and ok; n += 1 + n / 8)
+    {
+        KPoly const      f = random_poly(n);
+        Reducer<p> const red(f);
+        // Up to 2n - 2 the inverse is used, above the division.
+        for (size_t d : { size_t(0), n - 1, n, n + rng() % n, 2 * n - 2, 2 * n + 3 })
+        {
+            KPoly const a = random_poly(d);
+            if (red.reduce(a) != a % f)
+            {
+                cout << "p = " << K::modulus() << ": reduce of degree " << d << " modulo degree " << n << " is WRONG" << endl;
+                ok = false;
+            }
+        }
+        KPoly const          g = random_poly(rng() % (2 * n));
+        std::uint64_t const e = rng() % 100000;
+        if (red.powmod(g, e) != powmod(g, e, f))
+        {
+            cout << "p = " << K::modulus() << ": powmod modulo degree " << n << " is WRONG" << endl;
+            ok = false;
+        }
+    }
+    Reducer<p>::newton_threshold() = threshold;
+    if (ok) cout << "p = " << K::modulus() << ": Newton reduction agrees with division." << endl;
+    return ok;
+}
+
+int main()
+{
+    bool ok = check<3>(300);
+    ok = check<13>(300) and ok;
+    ok = check<19>(300) and ok;
+    for (unsigned q : { 251u, 2147483647u })
+    {
+        Z<0>::set_modulus(q);
+        ok = check<0>(300) and ok;
+    }
+    return ok ? 0 : 1;
+}
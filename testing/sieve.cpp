@@ -0,0 +1,49 @@
+// Compile with clang++-3.5 -std=c++14 -O2 -pthread -o "../bin/sieve" sieve.cpp
+
+/* This file is part of Modulus.
+ *
+ * Modulus is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+// This file tests the parallel sieves of "/src/sieve.hpp" against their serial versions.
+// getPolynomialsDecompositionPARALLEL must return the same map as getPolynomialsDecomposition.
+
+#include <iostream>
+
+#include "../src/sieve.hpp"
+
+using namespace std;
+using namespace Modulus;
+
+template <unsigned p>
+bool check(unsigned n)
+{
+    auto const serial   = getPolynomialsDecomposition<p>(n);
+    auto const parallel = getPolynomialsDecompositionPARALLEL<p>(n);
+    bool const same     = serial == parallel;
+    cout << "p = " << p << ", n = " << n << ": " << serial.size() << " decompositions"
+         << (same ? "" : ", the parallel map DIFFERS") << endl;
+    return same;
+}
+
+int main()
+{
+    bool ok = check<2>(12);
+    ok = check<3>(8) and ok;
+    ok = check<5>(5) and ok;
+    ok = check<7>(4) and ok;
+    return ok ? 0 : 1;
+}